@@ -0,0 +1,87 @@
+// Throughput benchmark of Array closures.
+// Compares graph of boxed Int applications with Array kernels and
+// per-element fallback.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace tori;
+
+namespace {
+
+  struct Add : Function<Add, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  constexpr size_t size = 1 << 20;
+
+  /// deep graphs are evaluated recursively
+  constexpr size_t boxed_size = 1 << 12;
+
+  /// \returns ns per element
+  template <class F>
+  double run(size_t n, F&& f)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / n;
+  }
+
+  void report(const char* name, double ns)
+  {
+    std::cout << std::setw(24) << std::left << name << std::setw(12)
+              << std::right << std::fixed << std::setprecision(3) << ns
+              << " ns/element" << std::endl;
+  }
+
+} // namespace
+
+int main()
+{
+  auto xs = make_object<IntArray>(size);
+  for (size_t i = 0; i < size; ++i)
+    (*xs)[i] = i % 1024;
+
+  volatile int sink = 0;
+
+  report("boxed sum", run(boxed_size, [&] {
+           object_ptr<const Object> g = make_object<Int>(0);
+           auto plus = make_object<PlusInt>();
+           for (size_t i = 0; i < boxed_size; ++i)
+             g = plus << g << make_object<Int>((*xs)[i]);
+           sink = *value_cast<Int>(eval(g));
+         }));
+
+  report("ArraySum", run(size, [&] {
+           sink = *eval(make_object<ArraySum<Int>>() << xs);
+         }));
+
+  report("ArrayFold (fallback)", run(size, [&] {
+           auto fold = make_object<ArrayFold<Int>>();
+           auto add = make_object<Add>();
+           sink = *eval(fold << add << make_object<Int>(0) << xs);
+         }));
+
+  report("ArrayMap", run(size, [&] {
+           auto map = make_object<ArrayMap<Int>>();
+           auto f = make_object<PlusInt>() << make_object<Int>(1);
+           sink = (*eval(map << f << xs))[0];
+         }));
+
+  report("ArrayMap (fallback)", run(size, [&] {
+           auto map = make_object<ArrayMap<Int>>();
+           auto f = make_object<Add>() << make_object<Int>(1);
+           sink = (*eval(map << f << xs))[0];
+         }));
+
+  (void)sink;
+}
@@ -0,0 +1,97 @@
+// Traversal of template graphs before and after compact().
+// Builds a large tree with nodes scattered over heap, then instantiates it
+// with copy_apply_graph() and evaluates the copy, which reads every node of
+// the template. Same for compacted template.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using namespace tori;
+
+namespace {
+
+  using clock = std::chrono::steady_clock;
+
+  constexpr size_t rounds = 32;
+  constexpr size_t leaves = 1 << 16;
+
+  /// balanced tree of additions; nodes are created in random order and
+  /// interleaved with short-lived objects.
+  object_ptr<const Object> build_scattered()
+  {
+    std::mt19937 rng {42};
+    auto plus = static_closure<PlusInt>();
+
+    std::vector<object_ptr<const Object>> garbage;
+    std::vector<size_t> order;
+
+    // create n nodes in random order
+    auto level = [&](size_t n, auto&& make) {
+      std::vector<object_ptr<const Object>> nodes(n);
+      order.resize(n);
+      for (size_t i = 0; i < n; ++i)
+        order[i] = i;
+      std::shuffle(order.begin(), order.end(), rng);
+      for (auto i : order) {
+        nodes[i] = make(i);
+        if (rng() % 2)
+          garbage.push_back(make_object<Int>(0));
+      }
+      return nodes;
+    };
+
+    auto nodes = level(leaves, [](size_t i) {
+      return object_ptr<const Object>(make_object<Int>(int(i % 7)));
+    });
+
+    while (nodes.size() > 1) {
+      nodes = level(nodes.size() / 2, [&](size_t i) {
+        return plus << nodes[2 * i] << nodes[2 * i + 1];
+      });
+    }
+    return nodes[0];
+  }
+
+  double run(const object_ptr<const Object>& graph)
+  {
+    volatile int sink = 0;
+    auto begin = clock::now();
+    for (size_t i = 0; i < rounds; ++i)
+      sink = *value_cast<Int>(eval(copy_apply_graph(graph)));
+    auto end = clock::now();
+    (void)sink;
+    return std::chrono::duration<double, std::milli>(end - begin).count() /
+           rounds;
+  }
+
+} // namespace
+
+int main()
+{
+  auto graph = build_scattered();
+
+  auto begin = clock::now();
+  auto g = compact(graph);
+  auto end = clock::now();
+
+  auto scattered = run(graph);
+  auto compacted = run(g.root());
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "scattered " << std::setw(10) << scattered << " ms/round"
+            << std::endl;
+  std::cout << "compacted " << std::setw(10) << compacted << " ms/round"
+            << std::endl;
+  std::cout << "compact() "
+            << std::setw(10)
+            << std::chrono::duration<double, std::milli>(end - begin).count()
+            << " ms (" << g.object_count() << " objects, " << g.size()
+            << " bytes)" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+// Compile-time benchmark of static type inference.
+// Builds a statically typed apply graph with TORI_BENCH_APPLY_COUNT applies
+// and evaluates it. Use compile_time.sh to measure build time and memory.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <iostream>
+
+#if !defined(TORI_BENCH_APPLY_COUNT)
+#  define TORI_BENCH_APPLY_COUNT 10
+#endif
+
+using namespace tori;
+
+namespace {
+
+  struct Add : Function<Add, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  /// graph of N applies, alternating monomorphic and polymorphic closures
+  template <size_t N>
+  auto make_graph()
+  {
+    if constexpr (N == 0)
+      return make_object<Int>(1);
+    else if constexpr (N % 3 == 1)
+      return make_object<Identity>() << make_graph<N - 1>();
+    else
+      return make_object<Add>() << make_graph<N - 2>() << make_object<Int>(1);
+  }
+
+} // namespace
+
+int main()
+{
+  auto graph = make_graph<TORI_BENCH_APPLY_COUNT>();
+  auto result = eval(graph);
+  std::cout << *result << std::endl;
+}
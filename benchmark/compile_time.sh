@@ -0,0 +1,15 @@
+#!/bin/sh
+# Measure build time and peak memory of compile_time.cpp.
+# usage: compile_time.sh [compiler] [apply counts...]
+# requires GNU time (/usr/bin/time).
+
+CXX=${1:-${CXX:-c++}}
+[ $# -gt 0 ] && shift
+COUNTS=${*:-"10 50 100 250 500"}
+DIR=$(cd "$(dirname "$0")" && pwd)
+
+for n in $COUNTS; do
+  /usr/bin/time -f "$n applies: %e s, %M KB" \
+    "$CXX" -std=c++17 -c -o /dev/null -I"$DIR/../include" \
+    -DTORI_BENCH_APPLY_COUNT="$n" "$DIR/compile_time.cpp" || exit 1
+done
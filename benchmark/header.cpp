@@ -0,0 +1,98 @@
+// Memory footprint and eval throughput of object headers.
+// Builds a balanced graph of PlusInt over a million leaves and reports
+// object sizes, heap usage and time to evaluate the graph.
+// See header_compact.cpp for TORI_COMPACT_HEADER.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+using namespace tori;
+
+namespace {
+
+  constexpr size_t leaves = 1 << 20;
+
+  /// heap bytes in use
+  size_t heap_usage()
+  {
+#if defined(__GLIBC__) && \
+  (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+  }
+
+  /// build balanced tree of additions
+  object_ptr<const Object> build(const object_ptr<const PlusInt>& plus)
+  {
+    std::vector<object_ptr<const Object>> nodes;
+    nodes.reserve(leaves);
+    for (size_t i = 0; i < leaves; ++i)
+      nodes.push_back(make_object<Int>(int(i % 7)));
+
+    while (nodes.size() > 1) {
+      for (size_t i = 0; i < nodes.size() / 2; ++i)
+        nodes[i] = plus << nodes[2 * i] << nodes[2 * i + 1];
+      nodes.resize(nodes.size() / 2);
+    }
+    return nodes[0];
+  }
+
+  void report_size(const char* name, size_t size)
+  {
+    std::cout << std::setw(24) << std::left << name << std::setw(12)
+              << std::right << size << " bytes" << std::endl;
+  }
+
+} // namespace
+
+int main()
+{
+  std::cout << (detail::compact_header_enabled ? "compact" : "default")
+            << " header" << std::endl;
+
+  report_size("sizeof(Object)", sizeof(Object));
+  report_size("sizeof(Bool)", sizeof(Bool));
+  report_size("sizeof(Int)", sizeof(Int));
+  report_size("sizeof(Apply)", sizeof(Apply));
+  report_size("sizeof(PlusInt)", sizeof(PlusInt));
+
+  auto plus = make_object<const PlusInt>();
+
+  auto heap0 = heap_usage();
+  auto begin = std::chrono::steady_clock::now();
+  auto g = build(plus);
+  auto built = std::chrono::steady_clock::now();
+  auto heap1 = heap_usage();
+  volatile int sink = *value_cast<Int>(eval(g));
+  auto end = std::chrono::steady_clock::now();
+  auto heap2 = heap_usage();
+  (void)sink;
+
+  // Int leaves + Apply nodes
+  auto nodes = leaves + 2 * (leaves - 1);
+
+  report_size("heap (graph)", heap1 - heap0);
+  report_size("heap (after eval)", heap2 - heap0);
+
+  std::cout << std::setw(24) << std::left << "build" << std::setw(12)
+            << std::right << std::fixed << std::setprecision(3)
+            << std::chrono::duration<double, std::nano>(built - begin).count() /
+                 nodes
+            << " ns/node" << std::endl;
+  std::cout << std::setw(24) << std::left << "eval" << std::setw(12)
+            << std::right << std::fixed << std::setprecision(3)
+            << std::chrono::duration<double, std::nano>(end - built).count() /
+                 nodes
+            << " ns/node" << std::endl;
+}
@@ -0,0 +1,5 @@
+// header.cpp with 8-byte object header.
+
+#define TORI_COMPACT_HEADER
+
+#include "header.cpp"
@@ -0,0 +1,115 @@
+// Eval throughput of memory management modes.
+// Repeatedly builds, evaluates and drops graphs, and reports time per round
+// including release of the graph. With TORI_ENABLE_GC, garbage is released
+// by gc_collect() after each round and its pause time is reported.
+// See memory_gc.cpp for TORI_ENABLE_GC.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace tori;
+
+namespace {
+
+  using clock = std::chrono::steady_clock;
+
+  constexpr size_t rounds = 32;
+  constexpr size_t leaves = 1 << 16;
+  constexpr int fib_n = 18;
+
+  /// Int -> Int
+  struct Fib : Function<Fib, Int, Int>
+  {
+    struct Impl : Function<Impl, closure<Int, Int>, Int, Int>
+    {
+      return_type code() const
+      {
+        auto fib = arg<0>();
+        auto n = eval_arg<1>();
+
+        if (*n < 2)
+          return n;
+
+        auto l = eval(fib << new Int(*n - 1));
+        auto r = eval(fib << new Int(*n - 2));
+        return new Int(*value_cast<Int>(l) + *value_cast<Int>(r));
+      }
+    };
+
+    return_type code() const
+    {
+      return static_closure<Fix>() << static_closure<Impl>() << arg<0>();
+    }
+  };
+
+  /// balanced tree of additions
+  object_ptr<const Object> build_tree()
+  {
+    auto plus = static_closure<PlusInt>();
+    std::vector<object_ptr<const Object>> nodes;
+    nodes.reserve(leaves);
+    for (size_t i = 0; i < leaves; ++i)
+      nodes.push_back(make_object<Int>(int(i % 7)));
+
+    while (nodes.size() > 1) {
+      for (size_t i = 0; i < nodes.size() / 2; ++i)
+        nodes[i] = plus << nodes[2 * i] << nodes[2 * i + 1];
+      nodes.resize(nodes.size() / 2);
+    }
+    return nodes[0];
+  }
+
+  /// naive fibonacci
+  object_ptr<const Object> build_fib()
+  {
+    return make_object<Fib>() << make_object<Int>(fib_n);
+  }
+
+  template <class F>
+  void run(const char* name, F&& build)
+  {
+    double total = 0;
+    double pause_total = 0;
+    double pause_max = 0;
+    volatile int sink = 0;
+
+    for (size_t i = 0; i < rounds; ++i) {
+      auto begin = clock::now();
+      {
+        auto g = build();
+        sink = *value_cast<Int>(eval(g));
+      }
+      auto end = clock::now();
+      gc_collect();
+      auto collected = clock::now();
+
+      auto pause =
+        std::chrono::duration<double, std::milli>(collected - end).count();
+      total += std::chrono::duration<double, std::milli>(end - begin).count();
+      pause_total += pause;
+      pause_max = std::max(pause_max, pause);
+    }
+    (void)sink;
+
+    std::cout << std::setw(8) << std::left << name << std::fixed
+              << std::setprecision(3) << std::setw(12) << std::right
+              << total / rounds << " ms/round" << std::setw(12)
+              << pause_total / rounds << " ms/pause" << std::setw(12)
+              << pause_max << " ms max pause" << std::endl;
+  }
+
+} // namespace
+
+int main()
+{
+  std::cout << (detail::gc_enabled ? "mark-sweep" : "refcount") << std::endl;
+
+  run("tree", build_tree);
+  run("fib", build_fib);
+}
\ No newline at end of file
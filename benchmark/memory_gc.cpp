@@ -0,0 +1,5 @@
+// memory.cpp with tracing collector.
+
+#define TORI_ENABLE_GC
+
+#include "memory.cpp"
\ No newline at end of file
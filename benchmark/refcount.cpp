@@ -0,0 +1,75 @@
+// Reference count traffic of primitive calls.
+// Counts atomic RMWs on reference counts per evaluation of `f << x << y`
+// on closures written with owning and borrowed argument access.
+
+#define TORI_ENABLE_REFCOUNT_STATS
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace tori;
+
+namespace {
+
+  /// lazy arguments, owning access
+  struct AddOwned : Function<AddOwned, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  /// lazy arguments, borrowed access
+  struct AddBorrowed : Function<AddBorrowed, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg_ref<0>() + *eval_arg_ref<1>());
+    }
+  };
+
+  constexpr size_t n = 1 << 16;
+
+  template <class F>
+  void run(const char* name)
+  {
+    auto f = make_object<F>();
+    auto x = make_object<Int>(1);
+    auto y = make_object<Int>(2);
+
+    volatile int sink = 0;
+    uint64_t atomics = 0;
+    double ns = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+      auto g = f << x << y;
+      reset_refcount_stats();
+      auto begin = std::chrono::steady_clock::now();
+      sink = *eval(g);
+      auto end = std::chrono::steady_clock::now();
+      auto stats = get_refcount_stats();
+      atomics += stats.increments + stats.decrements;
+      ns += std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+
+    (void)sink;
+
+    std::cout << std::setw(24) << std::left << name << std::setw(8)
+              << std::right << std::fixed << std::setprecision(1)
+              << double(atomics) / n << " atomics/call" << std::setw(12)
+              << std::setprecision(3) << ns / n << " ns/call" << std::endl;
+  }
+
+} // namespace
+
+int main()
+{
+  run<PlusInt>("PlusInt (strict)");
+  run<AddOwned>("eval_arg (lazy)");
+  run<AddBorrowed>("eval_arg_ref (lazy)");
+}
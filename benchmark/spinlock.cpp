@@ -0,0 +1,85 @@
+// Contention benchmark of Object::spinlock.
+// Compares current lock with naive exchange-only spin lock.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+using namespace tori;
+
+namespace {
+
+  /// previous implementation: spin on exchange
+  class naive_spinlock
+  {
+  public:
+    void lock() noexcept
+    {
+      while (m_atomic.exchange(1u, std::memory_order_acquire)) {
+        /* spin lock */
+      }
+    }
+
+    void unlock() noexcept
+    {
+      m_atomic.store(0u, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<uint8_t> m_atomic = 0;
+  };
+
+  constexpr uint64_t total_ops = 1 << 20;
+
+  /// run lock/unlock on a single lock from n threads
+  template <class Lock>
+  double run(Lock& lock, size_t n)
+  {
+    volatile uint64_t counter = 0;
+    std::atomic<bool> start   = false;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < n; ++i) {
+      threads.emplace_back([&] {
+        while (!start.load()) std::this_thread::yield();
+        for (uint64_t j = 0; j < total_ops / n; ++j) {
+          std::lock_guard guard {lock};
+          counter = counter + 1;
+        }
+      });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start      = true;
+    for (auto&& t : threads) t.join();
+    auto end = std::chrono::steady_clock::now();
+
+    if (counter != total_ops / n * n)
+      std::cerr << "broken lock!" << std::endl;
+
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+  }
+
+} // namespace
+
+int main()
+{
+  auto obj = make_object<Int>(42);
+  naive_spinlock naive;
+
+  std::cout << std::setw(8) << "threads" << std::setw(16) << "naive(ms)"
+            << std::setw(16) << "spinlock(ms)" << std::endl;
+
+  for (size_t n : {2, 4, 8, 16, 32, 64}) {
+    auto t0 = run(naive, n);
+    auto t1 = run(obj.get()->spinlock, n);
+    std::cout << std::setw(8) << n << std::setw(16) << std::fixed
+              << std::setprecision(2) << t0 << std::setw(16) << t1
+              << std::endl;
+  }
+}
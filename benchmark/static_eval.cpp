@@ -0,0 +1,94 @@
+// Benchmark of static_eval on fixed pipelines.
+// Builds statically typed graphs in advance and evaluates them with eval and
+// static_eval. Only evaluation is measured.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace tori;
+
+namespace {
+
+  /// lazy version of PlusInt
+  struct Add : Function<Add, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  constexpr size_t iterations = 1 << 14;
+
+  constexpr size_t batch = 64;
+
+  constexpr size_t depth = 6;
+
+  /// balanced tree of F with 2^N leaves
+  template <size_t N, class F>
+  auto make_tree(const object_ptr<F>& f, const object_ptr<Int>& x)
+  {
+    if constexpr (N == 0)
+      return x;
+    else
+      return f << make_tree<N - 1>(f, x) << make_tree<N - 1>(f, x);
+  }
+
+  /// \returns ns per graph
+  template <class F, class E>
+  double run(const object_ptr<F>& f, E&& e)
+  {
+    auto x = make_object<Int>(1);
+    volatile int sink = 0;
+    double ns = 0;
+
+    // small batches to keep graphs in cache
+    for (size_t n = 0; n < iterations; n += batch) {
+      std::vector<decltype(make_tree<depth>(f, x))> graphs;
+      for (size_t i = 0; i < batch; ++i)
+        graphs.push_back(make_tree<depth>(f, x));
+
+      auto begin = std::chrono::steady_clock::now();
+      for (auto&& g : graphs)
+        sink = *e(g);
+      auto end = std::chrono::steady_clock::now();
+
+      ns += std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+
+    (void)sink;
+    return ns / iterations;
+  }
+
+  void report(const char* name, double ns)
+  {
+    std::cout << std::setw(28) << std::left << name << std::setw(12)
+              << std::right << std::fixed << std::setprecision(1) << ns
+              << " ns/graph" << std::endl;
+  }
+
+  template <class F>
+  void bench(const char* name, const object_ptr<F>& f)
+  {
+    auto generic = run(f, [](auto& g) { return eval(g); });
+    auto fast = run(f, [](auto& g) { return static_eval(g); });
+
+    std::cout << name << " (" << (1 << depth) - 1 << " applies)\n";
+    report("  eval", generic);
+    report("  static_eval", fast);
+    std::cout << "  speedup: " << std::setprecision(2) << generic / fast << "x"
+              << std::endl;
+  }
+
+} // namespace
+
+int main()
+{
+  bench("PlusInt (strict)", make_object<PlusInt>());
+  bench("Add (lazy)", make_object<Add>());
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+// Benchmark of parallel type inference.
+// Compares type_of() and type_of_parallel() on wide graph.
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace tori;
+
+namespace {
+
+  /// balanced tree of 2^depth leaves
+  object_ptr<const Object> tree(size_t depth)
+  {
+    if (depth == 0)
+      return make_object<Identity>() << make_object<Int>(1);
+    return make_object<PlusInt>() << tree(depth - 1) << tree(depth - 1);
+  }
+
+  /// \returns ms
+  template <class F>
+  double run(F&& f)
+  {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+  }
+
+  void report(const char* name, double ms)
+  {
+    std::cout << std::setw(24) << std::left << name << std::setw(12)
+              << std::right << std::fixed << std::setprecision(3) << ms
+              << " ms" << std::endl;
+  }
+
+} // namespace
+
+int main()
+{
+  auto g = tree(14);
+
+  report("type_of", run([&] { (void)type_of(g); }));
+
+  for (size_t threads : {1, 2, 4, 8}) {
+    auto name = "type_of_parallel(" + std::to_string(threads) + ")";
+    report(name.c_str(), run([&] { (void)type_of_parallel(g, threads); }));
+  }
+}
@@ -24,9 +24,7 @@ struct Fib : Function<Fib, Int, Int>
 
   return_type code() const
   {
-    static const auto fix = make_object<Fix>();
-    static const auto impl = make_object<Impl>();
-    return fix << impl << arg<0>();
+    return static_closure<Fix>() << static_closure<Impl>() << arg<0>();
   }
 };
 
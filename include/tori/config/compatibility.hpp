@@ -35,34 +35,43 @@ namespace TORI_NS::detail {
   // class layout tests
 
   // Object
+#if defined(TORI_COMPACT_HEADER)
+  static_assert(sizeof(Object) == 8);
+  static_assert(offset_of_member(&Object::refcount) == 0);
+  static_assert(offset_of_member(&Object::info_index) == 4);
+#else
   static_assert(sizeof(Object) == 16);
   static_assert(offset_of_member(&Object::refcount) == 0);
   static_assert(offset_of_member(&Object::spinlock) == 4);
   static_assert(offset_of_member(&Object::info_table) == 8);
+#endif
 
   // object_info_table
-  static_assert(sizeof(object_info_table) == 32);
+  static_assert(sizeof(object_info_table) == 56);
   static_assert(offset_of_member(&object_info_table::obj_type) == 0);
   static_assert(offset_of_member(&object_info_table::obj_size) == 8);
   static_assert(offset_of_member(&object_info_table::destroy) == 16);
   static_assert(offset_of_member(&object_info_table::clone) == 24);
+  static_assert(offset_of_member(&object_info_table::visit) == 32);
+  static_assert(offset_of_member(&object_info_table::clone_at) == 40);
+  static_assert(offset_of_member(&object_info_table::finalize) == 48);
 
   // closure_info_table
-  static_assert(sizeof(closure_info_table) == 48);
-  static_assert(offset_of_member(&closure_info_table::n_args) == 32);
-  static_assert(offset_of_member(&closure_info_table::code) == 40);
+  static_assert(sizeof(closure_info_table) == 72);
+  static_assert(offset_of_member(&closure_info_table::n_args) == 56);
+  static_assert(offset_of_member(&closure_info_table::code) == 64);
 
-  static_assert(offset_of_member(&Box<char>::value) == 16);
-  static_assert(offset_of_member(&Box<int>::value) == 16);
-  static_assert(offset_of_member(&Box<long>::value) == 16);
+  static_assert(offset_of_member(&Box<char>::value) == sizeof(Object));
+  static_assert(offset_of_member(&Box<int>::value) == sizeof(Object));
+  static_assert(offset_of_member(&Box<long>::value) == sizeof(Object));
   // ...
 
-  static_assert(offset_of_member(&Closure<>::m_arity) == 16);
+  static_assert(offset_of_member(&Closure<>::m_arity) == sizeof(Object));
 
-  static_assert(offset_of_member(&ClosureN<1>::m_args) == 24);
-  static_assert(offset_of_member(&ClosureN<2>::m_args) == 24);
-  static_assert(offset_of_member(&ClosureN<3>::m_args) == 24);
-  static_assert(offset_of_member(&ClosureN<4>::m_args) == 24);
+  static_assert(offset_of_member(&ClosureN<1>::m_args) == sizeof(Object) + 8);
+  static_assert(offset_of_member(&ClosureN<2>::m_args) == sizeof(Object) + 8);
+  static_assert(offset_of_member(&ClosureN<3>::m_args) == sizeof(Object) + 8);
+  static_assert(offset_of_member(&ClosureN<4>::m_args) == sizeof(Object) + 8);
   // ...
 
 }
\ No newline at end of file
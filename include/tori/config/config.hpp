@@ -57,6 +57,48 @@ namespace TORI_NS::detail {
   constexpr bool debug_mode = true;
 #endif
 
+// profiler
+#if defined(TORI_ENABLE_PROFILER)
+  constexpr bool profiler_enabled = true;
+#else
+  constexpr bool profiler_enabled = false;
+#endif
+
+// tracer
+#if defined(TORI_ENABLE_TRACE)
+  constexpr bool trace_enabled = true;
+#else
+  constexpr bool trace_enabled = false;
+#endif
+
+// compact object header
+#if defined(TORI_COMPACT_HEADER)
+  constexpr bool compact_header_enabled = true;
+#else
+  constexpr bool compact_header_enabled = false;
+#endif
+
+// refcount statistics
+#if defined(TORI_ENABLE_REFCOUNT_STATS)
+  constexpr bool refcount_stats_enabled = true;
+#else
+  constexpr bool refcount_stats_enabled = false;
+#endif
+
+// heap statistics
+#if defined(TORI_ENABLE_HEAP_STATS)
+  constexpr bool heap_stats_enabled = true;
+#else
+  constexpr bool heap_stats_enabled = false;
+#endif
+
+// tracing collector
+#if defined(TORI_ENABLE_GC)
+  constexpr bool gc_enabled = true;
+#else
+  constexpr bool gc_enabled = false;
+#endif
+
 // env macros
 #if defined(_WIN32) || defined(_WIN64)
 #  if defined(_WIN64)
@@ -10,6 +10,27 @@
 #  include <intrin.h>
 #else
 #  include <x86intrin.h>
+#  include <cpuid.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+
+// Functions defined between TORI_TARGET_PUSH(isa) and TORI_TARGET_POP are
+// compiled for the instruction set regardless of compiler flags. Call them
+// only after checking get_simd_level().
+#define TORI_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#  define TORI_TARGET_PUSH(ISA) \
+    TORI_PRAGMA(clang attribute push(__attribute__((target(#ISA))), apply_to = function))
+#  define TORI_TARGET_POP TORI_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+#  define TORI_TARGET_PUSH(ISA) \
+    TORI_PRAGMA(GCC push_options) TORI_PRAGMA(GCC target(#ISA))
+#  define TORI_TARGET_POP TORI_PRAGMA(GCC pop_options)
+#else
+#  define TORI_TARGET_PUSH(ISA)
+#  define TORI_TARGET_POP
 #endif
 
 namespace TORI_NS::detail {
@@ -90,4 +111,130 @@ namespace TORI_NS::detail {
 #else
   constexpr bool has_AVX2 = false;
 #endif
-} // namespace TORI_NS::detail
\ No newline at end of file
+
+  // ------------------------------------------
+  // runtime detection
+
+  /// CPU features detected by cpuid
+  struct cpu_features
+  {
+    bool sse2 = false;
+    bool sse4_1 = false;
+    bool avx = false;
+    bool avx2 = false;
+  };
+
+  namespace interface {
+
+    /// Instruction set level of SIMD kernels
+    enum class simd_level : uint8_t
+    {
+      none,
+      sse2,
+      avx,
+      avx2,
+    };
+
+  } // namespace interface
+
+  /// cpuid
+  inline void
+    cpuid(uint32_t leaf, uint32_t subleaf, uint32_t (&regs)[4]) noexcept
+  {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+      regs[i] = static_cast<uint32_t>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+  }
+
+  /// xgetbv(0)
+  inline uint64_t xgetbv0() noexcept
+  {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+  }
+
+  /// Detect CPU features
+  [[nodiscard]] inline cpu_features detect_cpu_features() noexcept
+  {
+    cpu_features f;
+    uint32_t r[4];
+
+    cpuid(0, 0, r);
+    auto max_leaf = r[0];
+
+    if (max_leaf < 1)
+      return f;
+
+    cpuid(1, 0, r);
+    f.sse2 = r[3] & (1u << 26);
+    f.sse4_1 = r[2] & (1u << 19);
+
+    // OS should save XMM and YMM registers
+    bool osxsave = r[2] & (1u << 27);
+    f.avx = (r[2] & (1u << 28)) && osxsave && (xgetbv0() & 6) == 6;
+
+    if (max_leaf >= 7) {
+      cpuid(7, 0, r);
+      f.avx2 = f.avx && (r[1] & (1u << 5));
+    }
+    return f;
+  }
+
+  /// Get CPU features of this host
+  [[nodiscard]] inline const cpu_features& get_cpu_features() noexcept
+  {
+    static const cpu_features features = detect_cpu_features();
+    return features;
+  }
+
+  /// Highest SIMD level supported by this host
+  [[nodiscard]] inline interface::simd_level max_simd_level() noexcept
+  {
+    using interface::simd_level;
+    auto& f = get_cpu_features();
+    if (f.avx2)
+      return simd_level::avx2;
+    if (f.avx && f.sse4_1)
+      return simd_level::avx;
+    if (f.sse2)
+      return simd_level::sse2;
+    return simd_level::none;
+  }
+
+  /// SIMD level used by kernels.
+  /// \notes Zero-initialized to simd_level::none before dynamic
+  /// initialization, so kernels called during static initialization use
+  /// scalar code.
+  inline std::atomic<interface::simd_level> current_simd_level = {
+    max_simd_level()};
+
+  namespace interface {
+
+    /// Get SIMD level used by kernels
+    [[nodiscard]] inline simd_level get_simd_level() noexcept
+    {
+      return current_simd_level.load(std::memory_order_relaxed);
+    }
+
+    /// Restrict SIMD kernels to level.
+    /// Levels not supported by this host are clamped.
+    inline void set_simd_level(simd_level level) noexcept
+    {
+      auto max = max_simd_level();
+      current_simd_level.store(
+        level < max ? level : max, std::memory_order_relaxed);
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
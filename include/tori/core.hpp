@@ -8,16 +8,30 @@
 
 #include "core/object.hpp"
 #include "core/box.hpp"
+#include "core/weak_object_ptr.hpp"
 #include "core/type_gen.hpp"
 #include "core/static_typing.hpp"
 #include "core/dynamic_typing.hpp"
+#include "core/type_hash.hpp"
+#include "core/object_size.hpp"
 #include "core/string.hpp"
 #include "core/exception.hpp"
 #include "core/type_error.hpp"
 #include "core/value_cast.hpp"
 #include "core/apply.hpp"
+#include "core/profiler.hpp"
+#include "core/heap_stats.hpp"
+#include "core/trace.hpp"
+#include "core/apply_cache.hpp"
+#include "core/gc.hpp"
 #include "core/eval.hpp"
+#include "core/static_eval.hpp"
+#include "core/check_type.hpp"
+#include "core/parallel_typing.hpp"
 #include "core/fix.hpp"
+#include "core/incremental.hpp"
+#include "core/compact.hpp"
+#include "core/serialize.hpp"
 
 // compatibility check
 #include "config/compatibility.hpp"
\ No newline at end of file
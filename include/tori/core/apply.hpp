@@ -7,6 +7,7 @@
 #  include "../config/config.hpp"
 #  include "box.hpp"
 #  include "type_gen.hpp"
+#  include "object_ref.hpp"
 #endif
 
 namespace TORI_NS::detail {
@@ -63,14 +64,49 @@ namespace TORI_NS::detail {
       return clear_pointer_tag(m_arg);
     }
 
+    /// borrow cache of object
+    object_ref<const Object> cache_ref() const
+    {
+      TORI_ASSERT(evaluated());
+      return m_arg.get();
+    }
+
     /// set cache of object
     void set_cache(const object_ptr<const Object>& obj) const
     {
       TORI_ASSERT(!evaluated());
+      write_barrier();
       m_app = nullptr;
       m_arg = add_cache_tag(obj);
     }
 
+    /// discard cache (if any) and set new inputs
+    void reset(
+      object_ptr<const Object> app,
+      object_ptr<const Object> arg) const
+    {
+      write_barrier();
+      m_app = std::move(app);
+      m_arg = std::move(arg);
+    }
+
+    /// visit closure and argument (or cache)
+    void visit_children(object_visitor visitor) const
+    {
+      visitor(m_app);
+      visitor(m_arg);
+    }
+
+  private:
+    /// keep old values reachable from incremental collector
+    void write_barrier() const
+    {
+#if defined(TORI_ENABLE_GC)
+      gc_write_barrier(_get_storage(m_app).get());
+      gc_write_barrier(_get_storage(m_arg).get());
+#endif
+    }
+
   private:
     /// closure
     mutable object_ptr<const Object> m_app;
@@ -104,6 +140,12 @@ namespace TORI_NS::detail {
       return v.m_storage;
     }
 
+    /// visit closure and argument (or cache)
+    void visit_children(object_visitor visitor) const
+    {
+      m_storage.visit_children(visitor);
+    }
+
   private:
     apply_object_value_storage m_storage;
   };
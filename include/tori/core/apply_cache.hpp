@@ -0,0 +1,300 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Eviction of Apply result caches
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "apply.hpp"
+#  include "value_cast.hpp"
+#  include "object_size.hpp"
+#endif
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+
+namespace TORI_NS::detail {
+
+  // ------------------------------------------
+  // apply_cache
+
+  /// memory budget of Apply caches (0 = disabled)
+  inline std::atomic<size_t> apply_cache_budget = 0;
+
+  namespace interface {
+
+    /// Statistics of Apply cache eviction
+    struct apply_cache_stats
+    {
+      /// number of tracked Apply nodes
+      size_t tracked;
+      /// estimated size of cached results and inputs kept by table in bytes
+      size_t bytes;
+      /// number of caches dropped
+      size_t evictions;
+      /// number of evaluations of Apply nodes which were evicted
+      size_t recomputations;
+    };
+
+  } // namespace interface
+
+  /// CLOCK table of evaluated Apply nodes.
+  ///
+  /// Keeps inputs of each node so cached results can be dropped and
+  /// recomputed later. Entries of nodes which are only referenced from the
+  /// table are dropped incrementally on each insertion.
+  class apply_cache_table
+  {
+    struct entry
+    {
+      /// Apply node
+      object_ptr<const Apply> node;
+      /// closure (null while evicted)
+      object_ptr<const Object> app;
+      /// argument (null while evicted)
+      object_ptr<const Object> arg;
+      /// estimated size of result
+      size_t size;
+      /// estimated size of inputs
+      size_t inputs;
+      /// reference bit
+      bool referenced;
+      /// cache was dropped
+      bool evicted;
+    };
+
+  public:
+    /// add evaluated node and evict caches to fit the budget
+    void insert(
+      object_ptr<const Apply> node,
+      object_ptr<const Object> app,
+      object_ptr<const Object> arg,
+      size_t size)
+    {
+      auto inputs = object_size(app) + object_size(arg);
+
+      std::lock_guard lock {m_mtx};
+
+      auto [it, inserted] = m_index.emplace(node.get(), m_entries.size());
+
+      if (inserted) {
+        m_entries.push_back({std::move(node), //
+                             std::move(app),
+                             std::move(arg),
+                             size,
+                             inputs,
+                             false,
+                             false});
+      } else {
+        auto& e = m_entries[it->second];
+        if (e.evicted)
+          ++m_recomputations;
+        else
+          m_bytes -= e.size + e.inputs;
+        e.app = std::move(app);
+        e.arg = std::move(arg);
+        e.size = size;
+        e.inputs = inputs;
+        e.referenced = false;
+        e.evicted = false;
+      }
+      m_bytes += size + inputs;
+
+      // check more entries than inserted, so dead entries do not pile up.
+      prune(2);
+      sweep(apply_cache_budget.load(std::memory_order_relaxed));
+    }
+
+    /// set reference bit on cache hit
+    void touch(const Object* node)
+    {
+      std::lock_guard lock {m_mtx};
+      auto it = m_index.find(node);
+      if (it != m_index.end())
+        m_entries[it->second].referenced = true;
+    }
+
+    /// evict caches until total size fits `budget`
+    void shrink(size_t budget)
+    {
+      std::lock_guard lock {m_mtx};
+      prune(m_entries.size());
+      sweep(budget);
+    }
+
+    /// stop tracking all nodes.
+    /// \notes caches which are not evicted are kept.
+    void clear()
+    {
+      std::lock_guard lock {m_mtx};
+      m_entries.clear();
+      m_index.clear();
+      m_bytes = 0;
+      m_hand = 0;
+      m_prune = 0;
+    }
+
+    /// call function on node and inputs of each entry
+    template <class F>
+    void for_each_entry(F&& f) const
+    {
+      std::lock_guard lock {m_mtx};
+      for (auto&& e : m_entries)
+        f(e.node, e.app, e.arg);
+    }
+
+    /// drop entries of nodes which satisfy `pred`
+    template <class Pred>
+    void remove_if(Pred&& pred)
+    {
+      std::lock_guard lock {m_mtx};
+      for (size_t i = 0; i < m_entries.size();) {
+        if (pred(m_entries[i].node))
+          remove(i);
+        else
+          ++i;
+      }
+    }
+
+    /// get statistics
+    [[nodiscard]] apply_cache_stats stats() const
+    {
+      std::lock_guard lock {m_mtx};
+      return {m_entries.size(), m_bytes, m_evictions, m_recomputations};
+    }
+
+  private:
+    /// node is only referenced from this table?
+    /// \notes Reference counts are not maintained in gc mode, and collector
+    /// drops entries of unreachable nodes instead (see gc.hpp).
+    static bool is_dead([[maybe_unused]] const entry& e) noexcept
+    {
+      if constexpr (gc_enabled)
+        return false;
+      else
+        return e.node.use_count() == 1;
+    }
+
+    /// check up to `n` entries and drop dead ones
+    void prune(size_t n)
+    {
+      for (; n && !m_entries.empty(); --n) {
+        if (m_prune >= m_entries.size())
+          m_prune = 0;
+        if (is_dead(m_entries[m_prune]))
+          remove(m_prune);
+        else
+          ++m_prune;
+      }
+    }
+
+    void sweep(size_t budget)
+    {
+      while (m_bytes > budget && !m_entries.empty()) {
+
+        if (m_hand >= m_entries.size())
+          m_hand = 0;
+
+        auto& e = m_entries[m_hand];
+
+        if (is_dead(e)) {
+          remove(m_hand);
+          continue;
+        }
+
+        if (e.evicted) {
+          ++m_hand;
+          continue;
+        }
+
+        // second chance
+        if (e.referenced) {
+          e.referenced = false;
+          ++m_hand;
+          continue;
+        }
+
+        // drop cache and restore inputs
+#if defined(TORI_ENABLE_GC)
+        // node can be traced already in current marking
+        gc_write_barrier(_get_storage(e.app).get());
+        gc_write_barrier(_get_storage(e.arg).get());
+#endif
+        _get_storage(*e.node).reset(std::move(e.app), std::move(e.arg));
+        e.evicted = true;
+        m_bytes -= e.size + e.inputs;
+        ++m_evictions;
+        ++m_hand;
+      }
+    }
+
+    /// drop entry with its node, result and inputs
+    void remove(size_t i)
+    {
+      if (!m_entries[i].evicted)
+        m_bytes -= m_entries[i].size + m_entries[i].inputs;
+      m_index.erase(m_entries[i].node.get());
+      if (i != m_entries.size() - 1) {
+        m_entries[i] = std::move(m_entries.back());
+        m_index[m_entries[i].node.get()] = i;
+      }
+      m_entries.pop_back();
+    }
+
+  private:
+    mutable std::mutex m_mtx;
+    std::vector<entry> m_entries;
+    std::unordered_map<const Object*, size_t> m_index;
+    size_t m_hand = 0;
+    size_t m_prune = 0;
+    size_t m_bytes = 0;
+    size_t m_evictions = 0;
+    size_t m_recomputations = 0;
+  };
+
+  /// global apply cache table
+  [[nodiscard]] inline apply_cache_table& get_apply_cache_table()
+  {
+    static apply_cache_table table;
+    return table;
+  }
+
+  namespace interface {
+
+    /// Set memory budget of Apply caches in bytes.
+    ///
+    /// When non-zero, eval keeps inputs of evaluated Apply nodes and drops
+    /// cached results with CLOCK policy while estimated size of results
+    /// (see object_size()) and inputs kept for recomputation exceeds the
+    /// budget. Evicted nodes are recomputed on next eval. Nodes which are no
+    /// longer referenced outside of the table are released with their inputs.
+    /// 0 disables eviction and stops tracking (default).
+    /// \notes Graphs should not be evaluated concurrently in this mode.
+    inline void set_apply_cache_budget(size_t bytes)
+    {
+      apply_cache_budget.store(bytes, std::memory_order_relaxed);
+      if (bytes == 0)
+        get_apply_cache_table().clear();
+      else
+        get_apply_cache_table().shrink(bytes);
+    }
+
+    /// Get memory budget of Apply caches.
+    [[nodiscard]] inline size_t get_apply_cache_budget() noexcept
+    {
+      return apply_cache_budget.load(std::memory_order_relaxed);
+    }
+
+    /// Get statistics of Apply cache eviction.
+    [[nodiscard]] inline apply_cache_stats get_apply_cache_stats()
+    {
+      return get_apply_cache_table().stats();
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
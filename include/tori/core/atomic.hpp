@@ -9,14 +9,75 @@
 
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <limits>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+  defined(_M_IX86)
+#  include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define TORI_HAS_FUTEX 1
+#endif
 
 namespace TORI_NS::detail {
 
+  namespace interface {
+
+    /// Number of atomic RMWs on reference counts in current thread.
+    /// Only counted when `TORI_ENABLE_REFCOUNT_STATS` is defined.
+    struct refcount_stats
+    {
+      /// number of increments
+      uint64_t increments = 0;
+      /// number of decrements
+      uint64_t decrements = 0;
+    };
+
+  } // namespace interface
+
+  /// refcount counters of current thread
+  inline thread_local refcount_stats thread_refcount_stats;
+
+  namespace interface {
+
+    /// get refcount counters of current thread
+    [[nodiscard]] inline refcount_stats get_refcount_stats() noexcept
+    {
+      return thread_refcount_stats;
+    }
+
+    /// reset refcount counters of current thread
+    inline void reset_refcount_stats() noexcept
+    {
+      thread_refcount_stats = {};
+    }
+
+  } // namespace interface
+
   /// atomic reference count
   template <class T>
   class atomic_refcount
   {
   public:
+    /// set while object has weak references (see weak_object_ptr)
+    static constexpr T weak_flag = T(1) << (sizeof(T) * 8 - 1);
+
+    /// set when object is counted in heap statistics (see heap_stats.hpp)
+    static constexpr T heap_stats_flag = T(1) << (sizeof(T) * 8 - 2);
+
+    /// set when object is placed in block of compact() (see compact.hpp)
+    static constexpr T arena_flag = T(1) << (sizeof(T) * 8 - 3);
+
+    /// mask of reference count
+    static constexpr T count_mask =
+      ~(weak_flag | heap_stats_flag | arena_flag);
+
     constexpr atomic_refcount() noexcept
       : atomic {0}
     {
@@ -52,54 +113,219 @@ namespace TORI_NS::detail {
     /// use memory_order_relaxed
     T fetch_add() noexcept
     {
+      if constexpr (refcount_stats_enabled)
+        ++thread_refcount_stats.increments;
       return atomic.fetch_add(1u, std::memory_order_relaxed);
     }
 
     /// use memory_order_release
     T fetch_sub() noexcept
     {
+      if constexpr (refcount_stats_enabled)
+        ++thread_refcount_stats.decrements;
       return atomic.fetch_sub(1u, std::memory_order_release);
     }
 
+    /// increment when reference count is not zero
+    /// \returns true when incremented
+    bool increment_if_nonzero() noexcept
+    {
+      auto v = atomic.load(std::memory_order_relaxed);
+      while (v & count_mask) {
+        if (atomic.compare_exchange_weak(v, v + 1, std::memory_order_relaxed)) {
+          if constexpr (refcount_stats_enabled)
+            ++thread_refcount_stats.increments;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// set weak_flag
+    void set_weak_flag() noexcept
+    {
+      atomic.fetch_or(weak_flag, std::memory_order_relaxed);
+    }
+
+    /// clear weak_flag
+    void clear_weak_flag() noexcept
+    {
+      atomic.fetch_and(~weak_flag, std::memory_order_relaxed);
+    }
+
+    /// set heap_stats_flag
+    void set_heap_stats_flag() noexcept
+    {
+      atomic.fetch_or(heap_stats_flag, std::memory_order_relaxed);
+    }
+
+    /// set arena_flag
+    void set_arena_flag() noexcept
+    {
+      atomic.fetch_or(arena_flag, std::memory_order_relaxed);
+    }
+
   private:
     std::atomic<T> atomic;
     static_assert(std::atomic<T>::is_always_lock_free);
     static_assert(sizeof(T) == sizeof(std::atomic<T>));
   };
 
-  /// atomic spin lock
+  // ------------------------------------------
+  // spin wait
+
+  /// hint to CPU in spin-wait loop
+  inline void spin_pause() noexcept
+  {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+  defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+  }
+
+  /// Global parking lot for spin locks.
+  /// Locks are too small to have their own wait queue, so waiters park on
+  /// 32bit sequence counter of a bucket selected by address of the lock.
+  class spin_parking_lot
+  {
+  public:
+    /// Park current thread while `cond()` holds.
+    template <class F>
+    static void park(const void* addr, F&& cond) noexcept
+    {
+      auto& b = bucket(addr);
+      auto seq = b.seq.load(std::memory_order_seq_cst);
+      // recheck after reading sequence to not miss wake up
+      if (!cond())
+        return;
+#if defined(TORI_HAS_FUTEX)
+      syscall(
+        SYS_futex,
+        &b.seq,
+        FUTEX_WAIT_PRIVATE,
+        seq,
+        nullptr,
+        nullptr,
+        0);
+#else
+      (void)seq;
+      std::this_thread::yield();
+#endif
+    }
+
+    /// Wake up threads parked on bucket of `addr`.
+    static void unpark_all(const void* addr) noexcept
+    {
+      auto& b = bucket(addr);
+      b.seq.fetch_add(1, std::memory_order_seq_cst);
+#if defined(TORI_HAS_FUTEX)
+      syscall(
+        SYS_futex,
+        &b.seq,
+        FUTEX_WAKE_PRIVATE,
+        std::numeric_limits<int>::max(),
+        nullptr,
+        nullptr,
+        0);
+#endif
+    }
+
+  private:
+    struct alignas(64) bucket_t
+    {
+      std::atomic<uint32_t> seq = 0;
+    };
+
+    static constexpr size_t bucket_count = 64;
+
+    static bucket_t& bucket(const void* addr) noexcept
+    {
+      static bucket_t buckets[bucket_count];
+      auto h = reinterpret_cast<uintptr_t>(addr);
+      h ^= h >> 17;
+      h *= 0x9E3779B97F4A7C15ull;
+      return buckets[(h >> 32) % bucket_count];
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+  };
+
+  /// atomic spin lock.
+  ///
+  /// Test-and-test-and-set lock with pause hint and bounded exponential
+  /// backoff. Threads which failed to acquire lock after `spin_limit` rounds
+  /// are parked (futex on Linux), so contended locks do not burn cores.
+  /// State: 0 = unlocked, 1 = locked, 2 = locked and may have waiters.
   template <class T>
   class atomic_spinlock
   {
   public:
+    /// number of spin rounds before parking
+    static constexpr uint32_t spin_limit = 16;
+    /// maximum number of pause per spin round
+    static constexpr uint32_t backoff_limit = 64;
+
     constexpr atomic_spinlock() noexcept
-      : m_atomic {0u}
+      : m_atomic {unlocked}
     {
     }
 
     constexpr atomic_spinlock(bool flg) noexcept
-      : m_atomic {flg ? 1u : 0u}
+      : m_atomic {flg ? locked : unlocked}
     {
     }
 
     void lock() noexcept
     {
-      while (test_and_set()) {
-        /* spin lock */
-      }
+      if (TORI_LIKELY(try_lock()))
+        return;
+      lock_slow();
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+      T expected = unlocked;
+      return m_atomic.compare_exchange_strong(
+        expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
     }
 
     void unlock() noexcept
     {
-      m_atomic.store(0u, std::memory_order_release);
+      if (TORI_UNLIKELY(
+            m_atomic.exchange(unlocked, std::memory_order_release) == parked))
+        spin_parking_lot::unpark_all(this);
     }
 
   private:
-    bool test_and_set() noexcept
+    void lock_slow() noexcept
     {
-      return m_atomic.exchange(1u, std::memory_order_acquire);
+      uint32_t backoff = 1;
+
+      for (uint32_t i = 0; i < spin_limit; ++i) {
+        // spin on load to keep cache line shared
+        if (m_atomic.load(std::memory_order_relaxed) == unlocked && try_lock())
+          return;
+        for (uint32_t j = 0; j < backoff; ++j) spin_pause();
+        if (backoff < backoff_limit)
+          backoff *= 2;
+      }
+
+      // mark waiter and park. once a waiter exists, keep the state so that
+      // unlock() wakes remaining waiters.
+      while (m_atomic.exchange(parked, std::memory_order_acquire) != unlocked) {
+        spin_parking_lot::park(this, [&] {
+          return m_atomic.load(std::memory_order_seq_cst) == parked;
+        });
+      }
     }
 
+  private:
+    static constexpr T unlocked = 0;
+    static constexpr T locked   = 1;
+    static constexpr T parked   = 2;
+
   private:
     std::atomic<T> m_atomic;
     static_assert(std::atomic<T>::is_always_lock_free);
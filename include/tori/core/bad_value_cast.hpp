@@ -52,6 +52,13 @@ namespace TORI_NS::detail {
     object_ptr<const Type> from;
     /// cast to
     object_ptr<const Type> to;
+
+    /// visit types
+    void visit_children(object_visitor visitor) const
+    {
+      visitor(from);
+      visitor(to);
+    }
   };
 
   namespace interface {
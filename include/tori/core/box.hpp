@@ -5,12 +5,15 @@
 
 #if !defined(TORI_NO_LOCAL_INCLUDE)
 #  include "object_ptr.hpp"
+#  include "heap_stats.hpp"
 #  include "type_value.hpp" // clang requires definition of TypeValue to compile.
 #  include "specifiers.hpp"
 #  include "terms.hpp"
 #endif
 
+#include <new>
 #include <cassert>
+#include <cstddef>
 
 namespace TORI_NS::detail {
 
@@ -41,6 +44,8 @@ namespace TORI_NS::detail {
       std::is_nothrow_destructible_v<T>,
       "Boxed object should have nothrow destructor");
     auto *p = static_cast<const T *>(obj);
+    if constexpr (heap_stats_enabled)
+      heap_stats_remove(p);
     delete p;
   }
 
@@ -55,13 +60,76 @@ namespace TORI_NS::detail {
   {
     try {
       auto p = static_cast<const T *>(obj);
-      return new (std::nothrow) T {*p};
+      auto c = new (std::nothrow) T {*p};
+      if constexpr (heap_stats_enabled)
+        if (c)
+          heap_stats_add(c);
+      return c;
     } catch (...) {
       // TODO: return Exception object
       return nullptr;
     }
   }
 
+  /// has `visit_children(object_visitor)` member?
+  template <class T, class = void>
+  struct has_visit_children : std::false_type
+  {
+  };
+
+  template <class T>
+  struct has_visit_children<
+    T,
+    std::void_t<decltype(std::declval<const T &>().visit_children(
+      std::declval<object_visitor>()))>> : std::true_type
+  {
+  };
+
+  /// \brief vtable function to visit objects owned by object.
+  ///
+  /// Calls `visit_children(object_visitor)` of value when defined. Values
+  /// which have object_ptr members should define it to be traced by
+  /// collector (see gc.hpp).
+  template <class T>
+  void vtbl_visit_func(const Object *obj, object_visitor visitor) noexcept
+  {
+    if constexpr (has_visit_children<typename T::value_type>::value)
+      static_cast<const T *>(obj)->value.visit_children(visitor);
+  }
+
+  /// \brief vtable function to copy object into given memory.
+  ///
+  /// vtable function to relocate object into memory not owned by heap (see
+  /// compact.hpp). New object has 0 reference count.
+  /// \param mem memory of `obj_size` bytes aligned to max_align_t.
+  /// \returns pointer to generated object.
+  /// \notes return nullptr when initialization failed.
+  template <class T>
+  Object *vtbl_clone_at_func(const Object *obj, void *mem) noexcept
+  {
+    if constexpr (alignof(T) > alignof(std::max_align_t))
+      return nullptr;
+    else {
+      try {
+        auto p = static_cast<const T *>(obj);
+        auto c = ::new (mem) T {*p};
+        c->refcount = 0u;
+        return c;
+      } catch (...) {
+        return nullptr;
+      }
+    }
+  }
+
+  /// \brief vtable function to destroy object without releasing memory.
+  ///
+  /// vtable function to destroy object created by `clone_at`.
+  template <class T>
+  void vtbl_finalize_func(const Object *obj) noexcept
+  {
+    static_cast<const T *>(obj)->~T();
+  }
+
   /// inherit custom term from parameter type
   template <class T>
   constexpr auto inherit_box_term()
@@ -101,7 +169,8 @@ namespace TORI_NS::detail {
           !std::is_same_v<std::decay_t<U>, static_construct_t>>>
       constexpr Box(U &&u, Args &&... args) //
         noexcept(std::is_nothrow_constructible_v<T, U, Args...>)
-        : Object {&info_table_initializer::info_table}
+        : Object {
+            get_object_info_handle<&info_table_initializer::info_table>()}
         , value {std::forward<U>(u), std::forward<Args>(args)...}
       {
       }
@@ -119,7 +188,8 @@ namespace TORI_NS::detail {
       /// Ctor
       constexpr Box() //
         noexcept(std::is_nothrow_constructible_v<T>)
-        : Object {&info_table_initializer::info_table}
+        : Object {
+            get_object_info_handle<&info_table_initializer::info_table>()}
         , value {}
       {
       }
@@ -127,7 +197,8 @@ namespace TORI_NS::detail {
       /// Copy ctor
       constexpr Box(const Box &obj) //
         noexcept(std::is_nothrow_copy_constructible_v<T>)
-        : Object {&info_table_initializer::info_table}
+        : Object {
+            get_object_info_handle<&info_table_initializer::info_table>()}
         , value {obj.value}
       {
       }
@@ -135,7 +206,8 @@ namespace TORI_NS::detail {
       /// Move ctor
       constexpr Box(Box &&obj) //
         noexcept(std::is_nothrow_move_constructible_v<T>)
-        : Object {&info_table_initializer::info_table}
+        : Object {
+            get_object_info_handle<&info_table_initializer::info_table>()}
         , value {std::move(obj.value)}
       {
       }
@@ -167,7 +239,10 @@ namespace TORI_NS::detail {
         object_type<Box>(),                                            //
         sizeof(Box),                                                   //
         vtbl_destroy_func<Box>,                                        //
-        vtbl_clone_func<Box>};                                         //
+        vtbl_clone_func<Box>,                                          //
+        vtbl_visit_func<Box>,                                          //
+        vtbl_clone_at_func<Box>,                                       //
+        vtbl_finalize_func<Box>};                                      //
 
   } // namespace interface
 
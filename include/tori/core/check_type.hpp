@@ -0,0 +1,167 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "static_typing.hpp"
+#  include "dynamic_typing.hpp"
+#  include "type_gen.hpp"
+#  include "eval.hpp"
+#endif
+
+namespace TORI_NS::detail {
+
+  // ------------------------------------------
+  // static discharge of type check
+
+  /// Value types which do not represent actual type of objects.
+  /// `object_ptr<const Object>` and `object_ptr<Apply>` can point any graph.
+  template <class Tag>
+  constexpr auto is_dynamic_value_tag(meta_type<Tag> tag)
+  {
+    return tag == type_c<Object> || tag == type_c<Apply>;
+  }
+
+  /// Does the term describe actual type of object?
+  template <class Term>
+  constexpr auto is_static_term(meta_type<Term> term)
+  {
+    if constexpr (is_tm_apply(term))
+      return is_static_term(term.t1()) && is_static_term(term.t2());
+    else if constexpr (is_tm_value(term))
+      return !is_dynamic_value_tag(term.tag());
+    else
+      return true_c;
+  }
+
+  /// Is the type free from type variables and errors?
+  template <class T>
+  constexpr auto is_ground_type(meta_type<T> type)
+  {
+    if constexpr (is_value_type(type))
+      return true_c;
+    else if constexpr (is_arrow_type(type))
+      return is_ground_type(type.t1()) && is_ground_type(type.t2());
+    else
+      return false_c;
+  }
+
+  template <class T>
+  constexpr auto ground_type_to_term(meta_type<T> type);
+
+  template <class T, class... Ts>
+  constexpr auto ground_arrow_to_term(
+    meta_type<T> type,
+    meta_type<tm_closure<Ts...>>)
+  {
+    if constexpr (is_arrow_type(type)) {
+      using t1 = typename decltype(ground_type_to_term(type.t1()))::type;
+      return ground_arrow_to_term(type.t2(), type_c<tm_closure<Ts..., t1>>);
+    } else {
+      using t = typename decltype(ground_type_to_term(type))::type;
+      return type_c<tm_closure<Ts..., t>>;
+    }
+  }
+
+  /// Convert ground type to term which object_type_impl() accepts.
+  template <class T>
+  constexpr auto ground_type_to_term(meta_type<T> type)
+  {
+    if constexpr (is_value_type(type))
+      return type_c<tm_value<typename decltype(type.tag())::type>>;
+    else if constexpr (is_arrow_type(type))
+      return ground_arrow_to_term(type, type_c<tm_closure<>>);
+    else
+      static_assert(false_v<T>, "Not a ground type");
+  }
+
+  /// Compile time type of specifier or object type.
+  template <class T>
+  constexpr auto static_type_of()
+  {
+    constexpr auto spec = normalize_specifier(type_c<T>);
+    constexpr auto tp = get_proxy_type(spec);
+    return type_of(get_term(tp), false_c);
+  }
+
+  /// Infer type of graph using term of its static type.
+  /// Subgraphs which have fully known static type do not run runtime
+  /// inference and return static type object. Other parts fall back to
+  /// type_of().
+  template <class Term>
+  [[nodiscard]] object_ptr<const Type>
+    type_of_hybrid(const object_ptr<const Object>& obj, meta_type<Term> term)
+  {
+    constexpr auto type = type_of(term, false_c);
+
+    if constexpr (is_static_term(term) && is_ground_type(type)) {
+      (void)obj;
+      return object_type_impl(ground_type_to_term(type));
+    } else if constexpr (is_tm_apply(term)) {
+      auto apply = static_object_cast<const Apply>(obj);
+      auto& apply_storage = _get_storage(*apply);
+
+      if (apply_storage.evaluated())
+        return type_of(apply_storage.get_cache());
+
+      auto _t1 = type_of_hybrid(apply_storage.app(), term.t1());
+      auto _t2 = type_of_hybrid(apply_storage.arg(), term.t2());
+      auto _t = genvar();
+      auto c =
+        std::vector {Constr {_t1, make_object<Type>(arrow_type {_t2, _t})}};
+      auto s = unify(std::move(c), obj);
+      return subst_type_all(s, _t);
+    } else
+      return type_of(obj);
+  }
+
+  namespace interface {
+
+    /// check type
+    /// \notes When static type of `obj` is fully known and matches to `T`,
+    /// the check is discharged at compile time. Otherwise runtime inference
+    /// only runs on subgraphs which don't have static types.
+    /// \notes Static types of TApply nodes are trusted. Do not replace inputs
+    /// of them with objects of different types.
+    /// \throws type_error::bad_type_check when type does not match.
+    template <class T, class U>
+    void check_type(const object_ptr<U>& obj)
+    {
+      constexpr auto term = get_term<U>();
+      constexpr auto expected = static_type_of<T>();
+      constexpr auto type = type_of(term, false_c);
+
+      if constexpr (
+        is_static_term(term) && is_ground_type(type) &&
+        is_ground_type(expected) && type == expected) {
+        (void)obj;
+        return;
+      } else {
+        auto t1 = object_type<T>();
+        auto t2 = type_of_hybrid(obj, term);
+        if (TORI_UNLIKELY(!same_type(t1, t2)))
+          throw type_error::bad_type_check(t1, t2, obj);
+      }
+    }
+
+    /// Check type of graph and evaluate it.
+    /// \returns result of eval as `object_ptr` of `T`.
+    /// \throws type_error::bad_type_check when type does not match.
+    template <class T, class U>
+    [[nodiscard]] auto checked_eval(object_ptr<U> obj)
+    {
+      check_type<T>(obj);
+
+      auto result = eval_impl(obj);
+      TORI_ASSERT(result);
+
+      using To = std::add_const_t<
+        typename decltype(guess_object_type(static_type_of<T>()))::type>;
+      return static_object_cast<To>(std::move(result));
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
@@ -0,0 +1,417 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Relocation of graphs into contiguous memory
+///
+/// Graphs built with operator<< are scattered over heap in allocation order.
+/// compact() copies a graph into one block laid out in depth-first
+/// evaluation order (Apply node, then its closure, then its argument), so
+/// traversing the graph mostly walks memory forward.
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#  include "gc.hpp"
+#endif
+
+#include <new>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+
+namespace TORI_NS::detail {
+
+  /// Block of objects relocated by compact().
+  ///
+  /// Objects are created by `clone_at` of their info table and have
+  /// `arena_flag` in their reference count. References to them are counted
+  /// as usual, and objects are destroyed by `finalize` when count reaches 0
+  /// (see compact_arena_release()). Block is freed after all objects and
+  /// owner of arena are released.
+  /// In gc mode objects have 0 reference count like static objects, and are
+  /// destroyed with owner.
+  class compact_arena
+  {
+    /// map from source objects to relocated objects
+    using relocation_map =
+      std::unordered_map<const Object*, const Object*>;
+
+  public:
+    /// alignment of objects in block
+    static constexpr size_t object_align = alignof(std::max_align_t);
+    /// alignment of block
+    static constexpr size_t block_align = 64;
+
+    /// Ctor
+    /// \param graph root of graph
+    /// \param src arena which objects are relocated too (optional)
+    /// \throws std::bad_alloc when failed to copy object.
+    compact_arena(
+      const object_ptr<const Object>& graph,
+      const compact_arena* src)
+    {
+      if (!graph)
+        return;
+
+      // relocated objects
+      relocation_map map;
+
+      // depth-first order; closure of Apply comes before argument.
+      std::vector<const Object*> objs;
+      std::vector<const Object*> stack;
+      std::vector<const Object*> children;
+      size_t size = 0;
+
+      auto relocate = [&](const Object* obj) {
+        return obj->refcount.load() != 0 || (src && src->contains(obj));
+      };
+
+      if (relocate(graph.get()))
+        stack.push_back(graph.get());
+
+      while (!stack.empty()) {
+        auto obj = stack.back();
+        stack.pop_back();
+
+        if (!map.emplace(obj, nullptr).second)
+          continue;
+
+        objs.push_back(obj);
+        size += slot_size(obj);
+
+        children.clear();
+        get_info_table(obj)->visit(
+          obj,
+          {[](const object_ptr_storage& child, void* ctx) {
+             static_cast<std::vector<const Object*>*>(ctx)->push_back(
+               child.get());
+           },
+           &children});
+
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+          if (relocate(*it) && !map.count(*it))
+            stack.push_back(*it);
+      }
+
+      if (objs.empty()) {
+        m_root = graph;
+        return;
+      }
+
+      m_begin = static_cast<std::byte*>(
+        ::operator new(size, std::align_val_t {block_align}));
+      m_end = m_begin;
+
+      for (auto&& obj : objs) {
+        auto c = get_info_table(obj)->clone_at(obj, m_end);
+        if (TORI_UNLIKELY(!c)) {
+          release();
+          throw std::bad_alloc();
+        }
+        map[obj] = c;
+        m_end += slot_size(obj);
+      }
+
+      // redirect references to relocated objects
+      for_each([&](const Object* obj) {
+        get_info_table(obj)->visit(
+          obj,
+          {[](const object_ptr_storage& child, void* ctx) {
+             auto& relocated = *static_cast<relocation_map*>(ctx);
+             auto it = relocated.find(child.get());
+             if (it == relocated.end())
+               return;
+             // objects are not const
+             auto& storage = const_cast<object_ptr_storage&>(child);
+             auto tag = storage.get_pointer_tag();
+             storage.decrement_refcount();
+             storage = object_ptr_storage(it->second);
+             storage.set_pointer_tag(tag);
+             if constexpr (!gc_enabled)
+               it->second->refcount.fetch_add();
+           },
+           &map});
+      });
+
+      auto root = map[graph.get()];
+      m_count = objs.size();
+
+#if !defined(TORI_ENABLE_GC)
+      for_each([](const Object* obj) { obj->refcount.set_arena_flag(); });
+      root->refcount.fetch_add();
+      m_refs = m_count + 1;
+
+      auto& r = get_registry();
+      {
+        std::lock_guard lock {r.mtx};
+        r.arenas.emplace(m_begin, this);
+      }
+#endif
+
+      m_root = object_ptr<const Object>(root);
+
+#if defined(TORI_ENABLE_GC)
+      // heap objects referenced from block are not traced from heap
+      get_gc_collector().add_root_set(this, visit_roots);
+      visit_roots(
+        this,
+        {[](const object_ptr_storage& obj, void*) {
+           gc_write_barrier(obj.get());
+         },
+         nullptr});
+#endif
+    }
+
+    compact_arena(const compact_arena&) = delete;
+    compact_arena& operator=(const compact_arena&) = delete;
+
+    /// release reference from owner
+    void detach() noexcept
+    {
+      m_root = nullptr;
+      unref();
+    }
+
+    /// find arena which owns object
+    /// \returns nullptr when not found.
+    [[nodiscard]] static compact_arena* find(const Object* obj) noexcept
+    {
+      auto p = reinterpret_cast<const std::byte*>(obj);
+      auto& r = get_registry();
+      std::lock_guard lock {r.mtx};
+      auto it = r.arenas.upper_bound(p);
+      if (it == r.arenas.begin())
+        return nullptr;
+      --it;
+      return it->second->contains(obj) ? it->second : nullptr;
+    }
+
+    /// release reference from object in block
+    void unref() noexcept
+    {
+      if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+    }
+
+    /// get root
+    [[nodiscard]] const object_ptr<const Object>& root() const noexcept
+    {
+      return m_root;
+    }
+
+    /// number of objects in block
+    [[nodiscard]] size_t count() const noexcept
+    {
+      return m_count;
+    }
+
+    /// size of block
+    [[nodiscard]] size_t size() const noexcept
+    {
+      return static_cast<size_t>(m_end - m_begin);
+    }
+
+    /// object is in block?
+    [[nodiscard]] bool contains(const Object* obj) const noexcept
+    {
+      auto p = reinterpret_cast<const std::byte*>(obj);
+      return !std::less<const std::byte*>()(p, m_begin) &&
+             std::less<const std::byte*>()(p, m_end);
+    }
+
+  private:
+    /// Dtor
+    ~compact_arena() noexcept
+    {
+#if defined(TORI_ENABLE_GC)
+      if (m_begin)
+        get_gc_collector().remove_root_set(this);
+      release();
+#else
+      if (!m_begin)
+        return;
+      // objects are already released
+      auto& r = get_registry();
+      {
+        std::lock_guard lock {r.mtx};
+        r.arenas.erase(m_begin);
+      }
+      ::operator delete(m_begin, std::align_val_t {block_align});
+#endif
+    }
+
+    /// blocks of live arenas
+    struct registry
+    {
+      std::mutex mtx;
+      std::map<const std::byte*, compact_arena*> arenas;
+    };
+
+    /// get registry
+    static registry& get_registry()
+    {
+      // never destroyed; objects can be released after static destructors.
+      static auto r = new registry();
+      return *r;
+    }
+
+    /// size of object in block
+    static size_t slot_size(const Object* obj) noexcept
+    {
+      auto size = static_cast<size_t>(get_info_table(obj)->obj_size);
+      return (size + object_align - 1) & ~(object_align - 1);
+    }
+
+    /// call `f` on each object in block
+    template <class F>
+    void for_each(F&& f) const
+    {
+      for (auto p = m_begin; p != m_end;) {
+        auto obj = reinterpret_cast<const Object*>(p);
+        p += slot_size(obj);
+        f(obj);
+      }
+    }
+
+    /// visit objects referenced from block
+    static void visit_roots(const void* arena, object_visitor visitor)
+    {
+      static_cast<const compact_arena*>(arena)->for_each(
+        [&](const Object* obj) { get_info_table(obj)->visit(obj, visitor); });
+    }
+
+    /// destroy objects and free block
+    void release() noexcept
+    {
+      if (!m_begin)
+        return;
+      for_each([](const Object* obj) {
+        // weak references to objects without count are not flagged
+        get_weak_reference_table().expire(obj);
+        get_info_table(obj)->finalize(obj);
+      });
+      ::operator delete(m_begin, std::align_val_t {block_align});
+      m_begin = m_end = nullptr;
+    }
+
+  private:
+    /// root of graph
+    object_ptr<const Object> m_root;
+    /// block
+    std::byte* m_begin = nullptr;
+    /// end of objects
+    std::byte* m_end = nullptr;
+    /// number of objects
+    size_t m_count = 0;
+    /// number of live objects and owner
+    std::atomic<size_t> m_refs = 1;
+  };
+
+  /// destroy object in block of compact()
+  template <class T>
+  void compact_arena_release(const T* obj) noexcept
+  {
+    auto arena = compact_arena::find(obj);
+    TORI_ASSERT(arena);
+    get_info_table(obj)->finalize(obj);
+    arena->unref();
+  }
+
+  namespace interface {
+
+    /// Graph relocated into contiguous memory.
+    ///
+    /// Objects reachable from root are copied into one block in depth-first
+    /// evaluation order, preserving sharing. Static objects are referenced
+    /// as is. Copies are reference counted like heap objects, and the block
+    /// is freed after compacted_graph and all copies are released.
+    /// Nodes can be edited and evaluated as usual; run compact() again after
+    /// large edits to relocate new nodes.
+    /// \notes In gc mode copies are not counted and released at once when
+    /// compacted_graph is destroyed.
+    class compacted_graph
+    {
+    public:
+      /// Ctor
+      compacted_graph() noexcept = default;
+
+      /// Ctor
+      /// \param graph root of graph.
+      /// \throws std::bad_alloc when failed to copy object.
+      explicit compacted_graph(const object_ptr<const Object>& graph)
+        : compacted_graph(graph, nullptr)
+      {
+      }
+
+      /// get root
+      [[nodiscard]] const object_ptr<const Object>& root() const noexcept
+      {
+        return m_arena ? m_arena->root() : m_null;
+      }
+
+      /// number of relocated objects
+      [[nodiscard]] size_t object_count() const noexcept
+      {
+        return m_arena ? m_arena->count() : 0;
+      }
+
+      /// size of memory block in bytes
+      [[nodiscard]] size_t size() const noexcept
+      {
+        return m_arena ? m_arena->size() : 0;
+      }
+
+      /// object is owned by this graph?
+      template <class T>
+      [[nodiscard]] bool owns(const object_ptr<T>& obj) const noexcept
+      {
+        return m_arena && m_arena->contains(_get_storage(obj).get());
+      }
+
+    private:
+      compacted_graph(
+        const object_ptr<const Object>& graph,
+        const compact_arena* src)
+        : m_arena {new compact_arena(graph, src)}
+      {
+      }
+
+    public:
+      /// Relocate compacted graph again.
+      /// Objects owned by `graph` are copied together with new nodes.
+      [[nodiscard]] friend compacted_graph
+        compact(const compacted_graph& graph)
+      {
+        return compacted_graph(graph.root(), graph.m_arena.get());
+      }
+
+    private:
+      struct arena_deleter
+      {
+        void operator()(compact_arena* arena) const noexcept
+        {
+          arena->detach();
+        }
+      };
+      std::unique_ptr<compact_arena, arena_deleter> m_arena;
+      inline static const object_ptr<const Object> m_null = nullptr;
+    };
+
+    /// Relocate graph into contiguous memory.
+    /// \see compacted_graph
+    template <class T>
+    [[nodiscard]] compacted_graph compact(const object_ptr<T>& graph)
+    {
+      return compacted_graph(graph);
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
@@ -14,6 +14,7 @@
 #endif
 
 #include <vector>
+#include <atomic>
 
 namespace TORI_NS::detail {
 
@@ -42,6 +43,17 @@ namespace TORI_NS::detail {
         return object_type<Undefined>();
     }
 
+    /// \brief get **RAW** type of the object
+    /// \see get_type(const object_ptr<const Object>&)
+    template <class U>
+    [[nodiscard]] object_ptr<const Type> get_type(const object_ref<U>& obj)
+    {
+      if (obj)
+        return _get_storage(obj).info_table()->obj_type;
+      else
+        return object_type<Undefined>();
+    }
+
     /// is_value_type
     [[nodiscard]] inline bool is_value_type(const object_ptr<const Type>& tp)
     {
@@ -83,6 +95,13 @@ namespace TORI_NS::detail {
       return is_arrow_type(get_type(obj));
     }
 
+    /// has_arrow_type
+    template <class U>
+    [[nodiscard]] bool has_arrow_type(const object_ref<U>& obj)
+    {
+      return is_arrow_type(get_type(obj));
+    }
+
     /// has_var_type
     [[nodiscard]] inline bool has_var_type(const object_ptr<const Object>& obj)
     {
@@ -95,7 +114,7 @@ namespace TORI_NS::detail {
     copy_type_impl(const object_ptr<const Type>& ptp)
   {
     if (auto value = get_if<value_type>(ptp.value()))
-      return make_object<Type>(value_type {value->name});
+      return make_object<Type>(*value);
     if (auto var = get_if<var_type>(ptp.value()))
       return make_object<Type>(var_type {var->id});
     if (auto arrow = get_if<arrow_type>(ptp.value())) {
@@ -133,6 +152,12 @@ namespace TORI_NS::detail {
     const auto& left = *lhs;
     const auto& right = *rhs;
 
+    // different types when both hashes are cached
+    auto lhash = _get_storage(left).hash.load(std::memory_order_relaxed);
+    auto rhash = _get_storage(right).hash.load(std::memory_order_relaxed);
+    if (lhash && rhash && lhash != rhash)
+      return false;
+
     if (auto lvar = get_if<value_type>(&left)) {
       if (auto rvar = get_if<value_type>(&right))
         return value_type::compare(*lvar, *rvar);
@@ -168,7 +193,7 @@ namespace TORI_NS::detail {
 
     /// has_type
     template <class T, class U>
-    [[nodiscard]] bool has_type(const object_ptr<U>& obj)
+    [[nodiscard]] bool has_type(const object_ref<U>& obj)
     {
       if (same_type(get_type(obj), object_type<T>()))
         return true;
@@ -176,6 +201,13 @@ namespace TORI_NS::detail {
         return false;
     }
 
+    /// has_type
+    template <class T, class U>
+    [[nodiscard]] bool has_type(const object_ptr<U>& obj)
+    {
+      return has_type<T>(object_ref(obj));
+    }
+
   } // namespace interface
 
   struct TyArrow
@@ -343,11 +375,30 @@ namespace TORI_NS::detail {
   // ------------------------------------------
   // Recon
 
+  /// Generate unique ID for type variable.
+  /// Each thread takes block of IDs from global counter, so threads do not
+  /// contend on each call. IDs have MSB set to be distinct from IDs of static
+  /// type variables which are addresses.
+  [[nodiscard]] inline uint64_t gen_var_id() noexcept
+  {
+    constexpr uint64_t block_size = 1024;
+    constexpr uint64_t tag = uint64_t(1) << 63;
+
+    static std::atomic<uint64_t> next_block = {0};
+
+    thread_local uint64_t next = 0;
+    thread_local uint64_t end = 0;
+
+    if (TORI_UNLIKELY(next == end)) {
+      next = next_block.fetch_add(block_size, std::memory_order_relaxed);
+      end = next + block_size;
+    }
+    return tag | next++;
+  }
+
   [[nodiscard]] inline object_ptr<const Type> genvar()
   {
-    auto var = make_object<Type>(var_type {});
-    get_if<var_type>(var.value())->id = uintptr_t(var.get());
-    return object_ptr<const Type>(var);
+    return make_object<Type>(var_type {gen_var_id()});
   }
 
   inline void vars_impl(
@@ -405,6 +456,9 @@ namespace TORI_NS::detail {
     // Apply
     if (auto apply = value_cast_if<const Apply>(obj)) {
       auto& apply_storage = _get_storage(*apply);
+      // evaluated apply: type of result
+      if (apply_storage.evaluated())
+        return type_of_func_impl(apply_storage.get_cache());
       auto _t1 = type_of_func_impl(apply_storage.app());
       auto _t2 = type_of_func_impl(apply_storage.arg());
       auto _t = genvar();
@@ -8,8 +8,11 @@
 #  include "function.hpp"
 #  include "eval_error.hpp"
 #  include "result_error.hpp"
+#  include "apply_cache.hpp"
 #endif
 
+#include <atomic>
+
 namespace TORI_NS::detail {
 
   namespace interface {
@@ -34,9 +37,86 @@ namespace TORI_NS::detail {
 
   } // namespace interface
 
+  // ------------------------------------------
+  // indirection removal
+
+  /// short-circuit mode of eval
+  inline std::atomic<bool> short_circuit_eval = false;
+
+  namespace interface {
+
+    /// Enable indirection removal in eval.
+    ///
+    /// When enabled, eval rewrites references to evaluated Apply nodes in
+    /// inputs of Apply nodes and arguments of partially applied closures to
+    /// their results, so dead intermediate nodes can be freed and later
+    /// traversals skip them. Disabled by default.
+    /// \notes Graphs should not be evaluated concurrently in this mode.
+    inline void set_short_circuit_eval(bool enabled) noexcept
+    {
+      short_circuit_eval.store(enabled, std::memory_order_relaxed);
+    }
+
+    /// Indirection removal enabled?
+    [[nodiscard]] inline bool get_short_circuit_eval() noexcept
+    {
+      return short_circuit_eval.load(std::memory_order_relaxed);
+    }
+
+  } // namespace interface
+
+  /// get result of evaluated Apply node.
+  /// \returns nullptr when `obj` is not an evaluated Apply.
+  [[nodiscard]] inline object_ref<const Object>
+    get_indirection(object_ref<const Object> obj)
+  {
+    if (has_exception_tag(obj))
+      return nullptr;
+
+    if (auto apply = value_cast_if<Apply>(obj)) {
+      auto& storage = _get_storage(*apply);
+      if (storage.evaluated())
+        return storage.cache_ref();
+    }
+    return nullptr;
+  }
+
+  /// Replace evaluated Apply inputs of unevaluated Apply with their results.
+  inline void short_circuit_inputs(const apply_object_value_storage& storage)
+  {
+    auto app = get_indirection(storage.app());
+    auto arg = get_indirection(storage.arg());
+
+    if (!app && !arg)
+      return;
+
+    object_ptr<const Object> new_app = storage.app();
+    object_ptr<const Object> new_arg = storage.arg();
+
+    if (app)
+      new_app = app;
+    if (arg)
+      new_arg = arg;
+
+    storage.reset(std::move(new_app), std::move(new_arg));
+  }
+
+  /// Replace evaluated Apply arguments of closure with their results.
+  inline void short_circuit_args(const Closure<>* c)
+  {
+    auto n = c->n_args();
+    for (auto i = c->arity(); i < n; ++i) {
+      auto& a = c->arg(i);
+      if (auto r = get_indirection(a))
+        write_closure_arg(a, r);
+    }
+  }
+
   /// eval implementation
+  /// \notes `obj` is borrowed, so no reference count is taken on inputs
+  /// which are already in whnf.
   [[nodiscard]] inline object_ptr<const Object>
-    eval_impl(const object_ptr<const Object>& obj)
+    eval_impl(object_ref<const Object> obj)
   {
     // detect exception
     if (TORI_UNLIKELY(has_exception_tag(obj)))
@@ -51,11 +131,32 @@ namespace TORI_NS::detail {
 
       // graph reduction
       if (apply_storage.evaluated()) {
+        profile_cache_hit();
+        if (get_apply_cache_budget())
+          get_apply_cache_table().touch(apply.get());
         return apply_storage.get_cache();
       }
 
-      // whnf
-      auto app = eval_impl(apply_storage.app());
+      trace_scope trace {trace_kind::eval, nullptr};
+
+      const bool short_circuit = get_short_circuit_eval();
+
+      if (short_circuit)
+        short_circuit_inputs(apply_storage);
+
+      // keep inputs to recompute after eviction
+      const bool evictable = get_apply_cache_budget();
+      object_ptr<const Object> input_app, input_arg;
+      if (evictable) {
+        input_app = apply_storage.app();
+        input_arg = apply_storage.arg();
+      }
+
+      // whnf (borrow closure which is already in whnf)
+      object_ptr<const Object> app_whnf;
+      object_ref<const Object> app = apply_storage.app();
+      if (has_exception_tag(app) || value_cast_if<Apply>(app))
+        app = app_whnf = eval_impl(app);
 
       // alias: argument
       const auto& arg = apply_storage.arg();
@@ -74,6 +175,12 @@ namespace TORI_NS::detail {
         throw eval_error::too_many_arguments();
       }
 
+      profile_cache_miss(get_info_table(app.get()));
+
+      // partial application may outlive this node
+      if (short_circuit)
+        short_circuit_args(capp);
+
       // clone closure and apply
       auto ret = [&] {
         // clone
@@ -83,11 +190,14 @@ namespace TORI_NS::detail {
 
         // push argument
         auto arity = --cpap->arity();
-        cpap->arg(arity) = arg;
+        write_closure_arg(cpap->arg(arity), arg);
 
         // call code()
         if (TORI_UNLIKELY(arity == 0)) {
-          return eval_impl(cpap->code());
+          auto r = cpap->code();
+          if (is_whnf(r))
+            return r;
+          return eval_impl(r);
         }
 
         return pap;
@@ -96,40 +206,57 @@ namespace TORI_NS::detail {
       // set cache
       apply_storage.set_cache(ret);
 
+      if (evictable)
+        get_apply_cache_table().insert(
+          apply, std::move(input_app), std::move(input_arg), object_size(ret));
+
       return ret;
     }
 
     return obj;
   }
 
+  /// cast result of eval to static result type of `T`
+  template <class T>
+  [[nodiscard]] auto eval_result_cast(object_ptr<const Object> result)
+  {
+    TORI_ASSERT(result);
+
+    // for gcc 7
+    constexpr auto type = type_of(get_term<T>(), false_c);
+
+    // run compile time type check
+    if constexpr (!is_error_type(type)) {
+      // Currently object_ptr<T> MUST have type T which has compatible memory
+      // layout with actual object pointing to.
+      // Since it's impossible to decide memory layout of closure types,
+      // we convert it to closure<...> which is essentially equal to to
+      // Object. Type variables are also undecidable so we just convert
+      // them to Object.
+      using To =
+        std::add_const_t<typename decltype(guess_object_type(type))::type>;
+      // cast to resutn type
+      return static_object_cast<To>(std::move(result));
+    } else {
+      // fallback to object_ptr<>
+      return result;
+    }
+  }
+
   namespace interface {
 
     /// evaluate each apply node and replace with result
     template <class T>
-    [[nodiscard]] auto eval(object_ptr<T> obj)
+    [[nodiscard]] auto eval(object_ref<T> obj)
     {
-      auto result = eval_impl(std::move(obj));
-      TORI_ASSERT(result);
-
-      // for gcc 7
-      constexpr auto type = type_of(get_term<T>(), false_c);
-
-      // run compile time type check
-      if constexpr (!is_error_type(type)) {
-        // Currently object_ptr<T> MUST have type T which has compatible memory
-        // layout with actual object pointing to.
-        // Since it's impossible to decide memory layout of closure types,
-        // we convert it to closure<...> which is essentially equal to to
-        // Object. Type variables are also undecidable so we just convert
-        // them to Object.
-        using To =
-          std::add_const_t<typename decltype(guess_object_type(type))::type>;
-        // cast to resutn type
-        return static_object_cast<To>(result);
-      } else {
-        // fallback to object_ptr<>
-        return result;
-      }
+      return eval_result_cast<T>(eval_impl(obj));
+    }
+
+    /// evaluate each apply node and replace with result
+    template <class T>
+    [[nodiscard]] auto eval(const object_ptr<T>& obj)
+    {
+      return eval(object_ref(obj));
     }
 
   } // namespace interface
@@ -7,6 +7,7 @@
 #  include "box.hpp"
 #  include "string.hpp"
 #  include "object_cast.hpp"
+#  include "object_ref.hpp"
 #endif
 
 #include <exception>
@@ -32,6 +33,13 @@ namespace TORI_NS::detail {
     {
     }
 
+    /// visit message and error value
+    void visit_children(object_visitor visitor) const
+    {
+      visitor(message);
+      visitor(error_value);
+    }
+
     /// message
     object_ptr<const String> message;
     /// pointer to error value
@@ -62,6 +70,12 @@ namespace TORI_NS::detail {
     return _get_storage(obj).is_exception();
   }
 
+  template <class T>
+  [[nodiscard]] bool has_exception_tag(const object_ref<T>& obj)
+  {
+    return _get_storage(obj).is_exception();
+  }
+
   [[nodiscard]] inline object_ptr<const Exception>
     get_tagged_exception(const object_ptr<const Object>& obj)
   {
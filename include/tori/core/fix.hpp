@@ -39,10 +39,11 @@ namespace TORI_NS::detail {
 
           // build self-referencing closure
           auto arity = --cc->arity();
-          cc->arg(arity) = pap;
+          write_closure_arg(cc->arg(arity), pap);
 
-          // avoid memory leak
-          cc->refcount.fetch_sub();
+          // avoid memory leak (cycles are released by collector in gc mode)
+          if constexpr (!gc_enabled)
+            cc->refcount.fetch_sub();
 
           // eval
           if (TORI_UNLIKELY(arity == 0))
@@ -15,8 +15,13 @@
 #  include "result_error.hpp"
 #  include "type_error.hpp"
 #  include "value_cast.hpp"
+#  include "profiler.hpp"
+#  include "trace.hpp"
 #endif
 
+#include <new>
+#include <cstddef>
+
 namespace TORI_NS::detail {
 
   // ------------------------------------------
@@ -47,13 +52,15 @@ namespace TORI_NS::detail {
     /// Get number of args
     auto n_args() const noexcept
     {
-      return static_cast<const closure_info_table*>(info_table)->n_args;
+      auto info = static_cast<const closure_info_table*>(get_info_table(this));
+      return info->n_args;
     }
 
     /// Execute core with vtable function
     auto code() const noexcept
     {
-      return static_cast<const closure_info_table*>(info_table)->code(this);
+      auto info = static_cast<const closure_info_table*>(get_info_table(this));
+      return info->code(this);
     }
 
     /// get nth argument
@@ -94,15 +101,63 @@ namespace TORI_NS::detail {
     mutable std::array<object_ptr<const Object>, N> m_args = {};
   };
 
+  /// Write argument slot of closure in place.
+  /// Closures can be traced already while incremental marking is in
+  /// progress, so old value is marked like inputs of Apply (see apply.hpp).
+  inline void write_closure_arg(
+    object_ptr<const Object>& slot,
+    object_ptr<const Object> obj) noexcept
+  {
+#if defined(TORI_ENABLE_GC)
+    gc_write_barrier(_get_storage(slot).get());
+#endif
+    slot = std::move(obj);
+  }
+
+  // ------------------------------------------
+  // strict arguments
+
+  // forward decl
+  [[nodiscard]] inline object_ptr<const Object>
+    eval_impl(object_ref<const Object> obj);
+
+  /// Is the object already in whnf?
+  /// eval_impl() returns such object as it is.
+  [[nodiscard]] inline bool is_whnf(object_ref<const Object> obj)
+  {
+    return !has_exception_tag(obj) && !value_cast_if<Apply>(obj);
+  }
+
+  /// Evaluate strict arguments of saturated closure in place.
+  /// \param mask bit mask of strict arguments
+  inline void force_strict_args(const Closure<>* c, uint64_t mask)
+  {
+    auto n = c->n_args();
+    for (uint64_t i = 0; i < n && mask; ++i, mask >>= 1) {
+      if (mask & 1) {
+        auto& a = c->arg(n - i - 1);
+        if (!is_whnf(a))
+          write_closure_arg(a, eval_impl(a));
+      }
+    }
+  }
+
   // ------------------------------------------
   // vtbl_code_func
 
-  /// vrtable function to call code()
-  template <class T>
-  object_ptr<const Object> vtbl_code_func(const Closure<>* _this) noexcept
+  /// call code() of closure T
+  /// \param force_strict evaluates strict arguments before code()
+  template <class T, class F>
+  object_ptr<const Object>
+    call_code_func(const Closure<>* _this, F&& force_strict) noexcept
   {
+    profile_code_scope profile {get_info_table(_this)};
+    trace_scope trace {trace_kind::code, get_info_table(_this)};
+
     auto ret = [&]() -> object_ptr<const Object> {
       try {
+        force_strict();
+
         auto r = (static_cast<const T*>(_this)->exception_handler()).value();
         TORI_ASSERT(r);
         return r;
@@ -154,10 +209,32 @@ namespace TORI_NS::detail {
     // exception object retuned fron vtbl_code_func should have pointer tag
     if (!has_exception_tag(ret))
       TORI_ASSERT(!value_cast_if<Exception>(ret));
+    else
+      profile.exception();
 
     return ret;
   }
 
+  /// vrtable function to call code()
+  template <class T>
+  object_ptr<const Object> vtbl_code_func(const Closure<>* _this) noexcept
+  {
+    return call_code_func<T>(_this, [&] {
+      if constexpr (T::strict_args != 0)
+        force_strict_args(_this, T::strict_args);
+    });
+  }
+
+  /// vtable function to visit arguments of closure
+  inline void
+    vtbl_closure_visit_func(const Object* obj, object_visitor visitor) noexcept
+  {
+    auto c = static_cast<const Closure<>*>(obj);
+    auto n = c->n_args();
+    for (uint64_t i = 0; i < n; ++i)
+      visitor(c->arg(i));
+  }
+
   // ------------------------------------------
   // return type checking
 
@@ -188,11 +265,24 @@ namespace TORI_NS::detail {
       check_return_type(return_type, type_of(get_term<U>()));
     }
 
+    /// object_ref<U>
+    /// \effects takes new reference.
+    template <class U>
+    return_type_checker(object_ref<U> obj) noexcept
+      : m_value {obj}
+    {
+      // check return type
+      check_return_type(return_type, type_of(get_term<U>()));
+    }
+
     /// U*
     template <class U>
     return_type_checker(U* ptr) noexcept
       : m_value(ptr)
     {
+      // new object
+      if constexpr (heap_stats_enabled)
+        heap_stats_add(ptr);
       // check return type
       check_return_type(return_type, type_of(get_term<U>()));
     }
@@ -284,11 +374,21 @@ namespace TORI_NS::detail {
       static constexpr auto specifier =
         normalize_specifier(type_c<closure<Ts...>>);
 
+      /// bit mask of strict arguments
+      static constexpr uint64_t strict_args = get_strict_mask<Ts...>();
+
+      static_assert(
+        !is_strict_specifier(get<sizeof...(Ts) - 1>(tuple_c<Ts...>)),
+        "Return type cannot be strict");
+
+      static_assert(
+        sizeof...(Ts) - 1 <= 64 || strict_args == 0,
+        "strict is not supported after 64th argument");
+
       /// Ctor
       Function() noexcept
         : ClosureN<sizeof...(Ts) - 1> {
-            {{static_cast<const object_info_table*>(
-               &info_table_initializer::info_table)},
+            {{get_object_info_handle<&info_table_initializer::info_table>()},
              sizeof...(Ts) - 1},
           }
       {
@@ -298,8 +398,7 @@ namespace TORI_NS::detail {
       Function(const Function& other) noexcept
         : ClosureN<sizeof...(Ts) - 1> {
             {
-              {static_cast<const object_info_table*>(
-                &info_table_initializer::info_table)},
+              {get_object_info_handle<&info_table_initializer::info_table>()},
               other.m_arity,
             },
             other.m_args}
@@ -310,8 +409,7 @@ namespace TORI_NS::detail {
       Function(Function&& other) noexcept
         : ClosureN<sizeof...(Ts) - 1> {
             {
-              {static_cast<const object_info_table*>(
-                &info_table_initializer::info_table)},
+              {get_object_info_handle<&info_table_initializer::info_table>()},
               std::move(other.m_arity),
             },
             std::move(other.m_args)}
@@ -356,17 +454,51 @@ namespace TORI_NS::detail {
       {
         using To = argument_proxy_t<N>;
         static_assert(std::is_standard_layout_v<To>);
-        auto obj = ClosureN<sizeof...(Ts) - 1>::template nth_arg<N>();
+        auto& obj = ClosureN<sizeof...(Ts) - 1>::template nth_arg<N>();
         TORI_ASSERT(obj);
         return static_object_cast<To>(obj);
       }
 
+      /// borrow N'th argument thunk
+      /// \notes valid until code() returns.
+      template <uint64_t N>
+      [[nodiscard]] auto arg_ref() const noexcept
+      {
+        using To = argument_proxy_t<N>;
+        static_assert(std::is_standard_layout_v<To>);
+        auto& obj = ClosureN<sizeof...(Ts) - 1>::template nth_arg<N>();
+        TORI_ASSERT(obj);
+        return static_object_cast<To>(object_ref(obj));
+      }
+
       /// evaluate N'th argument and take result
       template <uint64_t N>
       [[nodiscard]] auto eval_arg() const
       {
-        // workaround: gcc 8.1
-        return eval(this->template arg<N>());
+        if constexpr (is_strict_specifier(get<N>(tuple_c<Ts...>))) {
+          // already evaluated before code()
+          using R = decltype(eval(this->template arg<N>()));
+          return static_object_cast<typename R::element_type>(
+            ClosureN<sizeof...(Ts) - 1>::template nth_arg<N>());
+        } else {
+          // workaround: gcc 8.1
+          return eval(this->template arg_ref<N>());
+        }
+      }
+
+      /// evaluate N'th argument and borrow result
+      /// \effects replaces the argument with its result.
+      /// \notes valid until code() returns.
+      template <uint64_t N>
+      [[nodiscard]] auto eval_arg_ref() const
+      {
+        using R = decltype(eval(this->template arg<N>()));
+        auto& obj = ClosureN<sizeof...(Ts) - 1>::template nth_arg<N>();
+        if constexpr (!is_strict_specifier(get<N>(tuple_c<Ts...>))) {
+          if (!is_whnf(obj))
+            write_closure_arg(obj, eval_impl(obj));
+        }
+        return static_object_cast<typename R::element_type>(object_ref(obj));
       }
 
     public:
@@ -413,10 +545,59 @@ namespace TORI_NS::detail {
         {object_type<T>(),                                       //
          sizeof(T),                                              //
          vtbl_destroy_func<T>,                                   //
-         vtbl_clone_func<T>},                                    //
+         vtbl_clone_func<T>,                                     //
+         vtbl_closure_visit_func,                                //
+         vtbl_clone_at_func<T>,                                  //
+         vtbl_finalize_func<T>},                                 //
         sizeof...(Ts) - 1,                                       //
         vtbl_code_func<T>};                                      //
 
   } // namespace interface
 
-} // namespace TORI_NS::detail
+  /// get info table of closure type
+  template <class T>
+  [[nodiscard]] const object_info_table* get_closure_info_table()
+  {
+    static const object_info_table* info = [] {
+      auto tmp = make_object<T>();
+      return _get_storage(tmp).info_table();
+    }();
+    return info;
+  }
+
+  // ------------------------------------------
+  // static_closure
+
+  /// closure with 0 reference count
+  template <class T>
+  struct static_closure_object : T
+  {
+    static_closure_object()
+      : T()
+    {
+      // set refcount ZERO to avoid deletion
+      this->refcount = 0u;
+    }
+  };
+
+  namespace interface {
+
+    /// Get statically allocated instance of closure `T`.
+    ///
+    /// The closure has 0 reference count like objects initialized with
+    /// `static_construct`, so copying pointers to it does no atomic
+    /// operation. It is never destroyed. Applications copy it as usual.
+    /// \requires `T` is default constructible Function.
+    template <class T>
+    [[nodiscard]] object_ptr<const T> static_closure()
+    {
+      // never destroyed; graphs can be released after static destructors.
+      alignas(static_closure_object<T>) static std::byte
+        storage[sizeof(static_closure_object<T>)];
+      static const T* closure = ::new (storage) static_closure_object<T>();
+      return closure;
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
@@ -0,0 +1,427 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Tracing collector
+///
+/// Define `TORI_ENABLE_GC` to release objects with mark-sweep collector
+/// instead of reference counting. In this mode copying object_ptr is plain
+/// pointer copy, and objects (including cycles made by Fix) are released by
+/// gc_collect() or gc_step() when they are not reachable from roots.
+/// Objects are traced through `visit` function of their info table.
+///
+/// Roots are registered with add_gc_root() or gc_root. Objects which are
+/// only referenced from C++ variables are NOT roots, so collector should be
+/// called where all live objects are reachable from roots.
+/// When disabled, gc_root is plain holder of object_ptr and collector does
+/// nothing.
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#  include "weak_reference.hpp"
+#  include "apply_cache.hpp"
+#endif
+
+#if defined(TORI_ENABLE_GC)
+#  include <array>
+#  include <mutex>
+#  include <limits>
+#  include <vector>
+#  include <unordered_map>
+#endif
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    /// Statistics of collector
+    struct gc_stats
+    {
+      /// number of objects survived last collection
+      size_t objects;
+      /// number of completed collections
+      size_t collections;
+      /// number of objects released
+      size_t freed;
+    };
+
+  } // namespace interface
+
+#if defined(TORI_ENABLE_GC)
+
+  /// Mark-sweep collector.
+  ///
+  /// Marking can be split into steps. Objects allocated during marking are
+  /// marked, and Apply nodes mark old values before updating them (see
+  /// gc_write_barrier()), so objects reachable from roots at start of
+  /// marking survive the collection.
+  class gc_collector
+  {
+  public:
+    /// add root
+    void add_root(const Object* obj)
+    {
+      std::lock_guard lock {m_mtx};
+      ++m_roots[obj];
+      gc_write_barrier(obj);
+    }
+
+    /// remove root
+    void remove_root(const Object* obj) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+      auto it = m_roots.find(obj);
+      if (it != m_roots.end() && --it->second == 0)
+        m_roots.erase(it);
+    }
+
+    /// add objects referenced from memory outside of heap.
+    /// `visit` is called with `key` at start of each marking.
+    void add_root_set(
+      const void* key,
+      void (*visit)(const void*, object_visitor))
+    {
+      std::lock_guard lock {m_mtx};
+      m_root_sets[key] = visit;
+    }
+
+    /// remove objects added by add_root_set()
+    void remove_root_set(const void* key) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+      m_root_sets.erase(key);
+    }
+
+    /// run marking for `work` objects, then sweep when marking finished.
+    /// \returns true when collection completed.
+    bool step(size_t work)
+    {
+      std::lock_guard lock {m_mtx};
+
+      if (!get_gc_heap().marking())
+        begin();
+
+      if (!mark(work))
+        return false;
+
+      // inputs of live Apply caches can make more objects reachable
+      if (mark_apply_cache())
+        return false;
+
+      prune_apply_cache();
+      sweep();
+      return true;
+    }
+
+    /// get statistics
+    [[nodiscard]] gc_stats stats() const
+    {
+      std::lock_guard lock {m_mtx};
+      return m_stats;
+    }
+
+  private:
+    /// mark object
+    /// \requires mark mutex of heap is locked.
+    static void shade(const Object* obj)
+    {
+      // static objects are not on heap
+      if (obj->refcount.load() != 0)
+        get_gc_heap().shade(obj);
+    }
+
+    /// start marking and mark roots
+    void begin()
+    {
+      auto& heap = get_gc_heap();
+
+      heap.begin_mark();
+
+      std::lock_guard lock {heap.mark_mutex()};
+
+      for (auto&& [obj, count] : m_roots) {
+        (void)count;
+        shade(obj);
+      }
+
+      object_visitor visitor {
+        [](const object_ptr_storage& obj, void*) { shade(obj.get()); },
+        nullptr};
+
+      for (auto&& [key, visit] : m_root_sets)
+        visit(key, visitor);
+    }
+
+    /// trace gray objects
+    /// \returns true when marking finished.
+    bool mark(size_t work)
+    {
+      auto& heap = get_gc_heap();
+
+      std::lock_guard lock {heap.mark_mutex()};
+
+      object_visitor visitor {
+        [](const object_ptr_storage& obj, void*) { shade(obj.get()); },
+        nullptr};
+
+      for (; work; --work) {
+        auto obj = static_cast<const Object*>(heap.pop_gray());
+        if (!obj)
+          return true;
+        get_info_table(obj)->visit(obj, visitor);
+      }
+      return !heap.has_gray();
+    }
+
+    /// object is marked?
+    /// \requires mark mutex of heap is locked.
+    static bool marked(const Object* obj) noexcept
+    {
+      return obj->refcount.load() == 0 || get_gc_heap().marked(obj);
+    }
+
+    /// Mark inputs of Apply caches whose node is marked.
+    /// Apply cache table does not keep nodes alive, but keeps inputs of live
+    /// nodes for recomputation.
+    /// \returns true when objects were marked.
+    bool mark_apply_cache()
+    {
+      auto& heap = get_gc_heap();
+
+      // table is locked before mark mutex (see apply_cache_table::sweep())
+      std::vector<std::array<const Object*, 3>> entries;
+      get_apply_cache_table().for_each_entry(
+        [&](auto& node, auto& app, auto& arg) {
+          entries.push_back({_get_storage(node).get(),
+                             _get_storage(app).get(),
+                             _get_storage(arg).get()});
+        });
+
+      std::lock_guard lock {heap.mark_mutex()};
+
+      for (auto&& [node, app, arg] : entries) {
+        if (!marked(node))
+          continue;
+        if (app)
+          shade(app);
+        if (arg)
+          shade(arg);
+      }
+      return heap.has_gray();
+    }
+
+    /// drop Apply cache entries of unmarked nodes
+    void prune_apply_cache()
+    {
+      auto& heap = get_gc_heap();
+      get_apply_cache_table().remove_if([&](auto& node) {
+        std::lock_guard lock {heap.mark_mutex()};
+        return !marked(_get_storage(node).get());
+      });
+    }
+
+    /// release unmarked objects
+    void sweep() noexcept
+    {
+      auto& heap = get_gc_heap();
+      auto epoch = heap.epoch();
+
+      // objects allocated after this point are not swept
+      auto list = heap.detach();
+      heap.end_mark();
+
+      gc_header* first = nullptr;
+      gc_header* last = nullptr;
+      size_t objects = 0;
+
+      while (list) {
+        auto h = list;
+        list = h->next;
+
+        auto obj = reinterpret_cast<const Object*>(h + 1);
+
+        if (!h->dead && h->mark != epoch) {
+          auto& refcount = obj->refcount;
+          // detach weak references
+          if (TORI_UNLIKELY(refcount.load() & refcount.weak_flag))
+            get_weak_reference_table().expire(obj);
+          get_info_table(obj)->destroy(obj);
+          ++m_stats.freed;
+        }
+
+        // destroyed objects are only marked as dead
+        if (h->dead) {
+          ::operator delete(h);
+          continue;
+        }
+
+        h->next = first;
+        first = h;
+        if (!last)
+          last = h;
+        ++objects;
+      }
+
+      heap.splice(first, last);
+
+      m_stats.objects = objects;
+      ++m_stats.collections;
+    }
+
+  private:
+    mutable std::mutex m_mtx;
+    std::unordered_map<const Object*, size_t> m_roots;
+    std::unordered_map<const void*, void (*)(const void*, object_visitor)>
+      m_root_sets;
+    gc_stats m_stats = {};
+  };
+
+  /// get collector
+  [[nodiscard]] inline gc_collector& get_gc_collector()
+  {
+    // never destroyed; roots can be removed after static destructors.
+    static auto collector = new gc_collector();
+    return *collector;
+  }
+
+#endif
+
+  namespace interface {
+
+    /// Register object as root of collector.
+    /// Roots are counted, so each call should be paired with
+    /// remove_gc_root().
+    template <class T>
+    void add_gc_root([[maybe_unused]] const object_ptr<T>& obj)
+    {
+#if defined(TORI_ENABLE_GC)
+      if (auto p = _get_storage(obj).get())
+        get_gc_collector().add_root(p);
+#endif
+    }
+
+    /// Unregister root of collector.
+    template <class T>
+    void remove_gc_root([[maybe_unused]] const object_ptr<T>& obj) noexcept
+    {
+#if defined(TORI_ENABLE_GC)
+      if (auto p = _get_storage(obj).get())
+        get_gc_collector().remove_root(p);
+#endif
+    }
+
+    /// Run full collection.
+    /// \notes Other threads should not use objects while collecting.
+    inline void gc_collect()
+    {
+#if defined(TORI_ENABLE_GC)
+      while (!get_gc_collector().step(std::numeric_limits<size_t>::max()))
+        ;
+#endif
+    }
+
+    /// Run incremental collection.
+    ///
+    /// Traces up to `work` objects, and sweeps heap when marking finished.
+    /// Graphs can be evaluated between steps; objects reachable from roots
+    /// when marking started and objects allocated after that survive.
+    /// \returns true when collection completed.
+    /// \notes Other threads should not use objects while running a step.
+    inline bool gc_step([[maybe_unused]] size_t work)
+    {
+#if defined(TORI_ENABLE_GC)
+      return get_gc_collector().step(work);
+#else
+      return true;
+#endif
+    }
+
+    /// Get statistics of collector.
+    /// \returns zero when collector is disabled.
+    [[nodiscard]] inline gc_stats get_gc_stats()
+    {
+#if defined(TORI_ENABLE_GC)
+      return get_gc_collector().stats();
+#else
+      return {};
+#endif
+    }
+
+    // ------------------------------------------
+    // gc_root
+
+    /// Scoped root of collector.
+    ///
+    /// Holds object and registers it as root while alive.
+    template <class T = Object>
+    class gc_root
+    {
+    public:
+      /// Constructor
+      gc_root() noexcept = default;
+
+      /// Constructor
+      gc_root(object_ptr<T> obj)
+        : m_ptr {std::move(obj)}
+      {
+        add_gc_root(m_ptr);
+      }
+
+      /// Copy constructor
+      gc_root(const gc_root& other)
+        : gc_root(other.m_ptr)
+      {
+      }
+
+      /// Destructor
+      ~gc_root() noexcept
+      {
+        remove_gc_root(m_ptr);
+      }
+
+      /// operator=
+      gc_root& operator=(const gc_root& other)
+      {
+        gc_root(other).swap(*this);
+        return *this;
+      }
+
+      /// swap
+      void swap(gc_root& other) noexcept
+      {
+        m_ptr.swap(other.m_ptr);
+      }
+
+      /// get object
+      [[nodiscard]] const object_ptr<T>& get() const noexcept
+      {
+        return m_ptr;
+      }
+
+      /// get object
+      [[nodiscard]] operator const object_ptr<T>&() const noexcept
+      {
+        return m_ptr;
+      }
+
+      /// operator*
+      [[nodiscard]] auto& operator*() const noexcept
+      {
+        return *m_ptr;
+      }
+
+      /// operator->
+      [[nodiscard]] auto* operator-> () const noexcept
+      {
+        return m_ptr.operator->();
+      }
+
+    private:
+      object_ptr<T> m_ptr;
+    };
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
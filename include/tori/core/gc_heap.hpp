@@ -0,0 +1,187 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Heap of tracing collector
+///
+/// Define `TORI_ENABLE_GC` to allocate objects on collected heap (see
+/// gc.hpp). Each object is prefixed with a small header which links all
+/// objects and keeps mark of collector.
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#endif
+
+#if defined(TORI_ENABLE_GC)
+#  include <new>
+#  include <mutex>
+#  include <atomic>
+#  include <vector>
+#endif
+
+namespace TORI_NS::detail {
+
+#if defined(TORI_ENABLE_GC)
+
+  /// header placed before each object
+  struct alignas(16) gc_header
+  {
+    /// next object in heap
+    gc_header* next;
+    /// epoch of last mark
+    uint32_t mark;
+    /// released by operator delete
+    uint32_t dead;
+  };
+
+  /// List of all heap objects and marking state of collector
+  class gc_heap
+  {
+  public:
+    /// allocate object
+    [[nodiscard]] void* allocate(std::size_t size)
+    {
+      return push(::operator new(sizeof(gc_header) + size));
+    }
+
+    /// allocate object
+    [[nodiscard]] void*
+      allocate(std::size_t size, const std::nothrow_t&) noexcept
+    {
+      auto p = ::operator new(sizeof(gc_header) + size, std::nothrow);
+      return p ? push(p) : nullptr;
+    }
+
+    /// release object.
+    /// \notes memory is freed on next sweep, since object is still linked.
+    void deallocate(void* p) noexcept
+    {
+      header(p)->dead = 1;
+    }
+
+    /// get header of object
+    [[nodiscard]] static gc_header* header(const void* p) noexcept
+    {
+      return static_cast<gc_header*>(const_cast<void*>(p)) - 1;
+    }
+
+    /// take all objects.
+    /// objects allocated after this call are linked to new list.
+    [[nodiscard]] gc_header* detach() noexcept
+    {
+      return m_head.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    /// link list of objects back to heap
+    void splice(gc_header* first, gc_header* last) noexcept
+    {
+      if (!first)
+        return;
+      last->next = m_head.load(std::memory_order_relaxed);
+      while (!m_head.compare_exchange_weak(
+        last->next, first, std::memory_order_release))
+        ;
+    }
+
+    /// marking in progress?
+    [[nodiscard]] bool marking() const noexcept
+    {
+      return m_alloc_mark.load(std::memory_order_relaxed) != 0;
+    }
+
+    /// current epoch
+    [[nodiscard]] uint32_t epoch() const noexcept
+    {
+      return m_epoch;
+    }
+
+    /// start marking.
+    /// objects allocated until end_mark() are marked.
+    void begin_mark() noexcept
+    {
+      if (++m_epoch == 0)
+        ++m_epoch;
+      m_alloc_mark.store(m_epoch, std::memory_order_relaxed);
+    }
+
+    /// finish marking
+    void end_mark() noexcept
+    {
+      m_alloc_mark.store(0, std::memory_order_relaxed);
+    }
+
+    /// lock of marking state
+    [[nodiscard]] std::mutex& mark_mutex() noexcept
+    {
+      return m_mtx;
+    }
+
+    /// mark object and push it to gray stack.
+    /// \requires mark_mutex() is locked.
+    void shade(const void* p)
+    {
+      auto h = header(p);
+      if (h->mark == m_epoch)
+        return;
+      h->mark = m_epoch;
+      m_gray.push_back(p);
+    }
+
+    /// object is marked in current marking?
+    /// \requires mark_mutex() is locked.
+    [[nodiscard]] bool marked(const void* p) const noexcept
+    {
+      return header(p)->mark == m_epoch;
+    }
+
+    /// pop object from gray stack.
+    /// \requires mark_mutex() is locked.
+    [[nodiscard]] const void* pop_gray() noexcept
+    {
+      if (m_gray.empty())
+        return nullptr;
+      auto p = m_gray.back();
+      m_gray.pop_back();
+      return p;
+    }
+
+    /// gray stack is not empty?
+    /// \requires mark_mutex() is locked.
+    [[nodiscard]] bool has_gray() const noexcept
+    {
+      return !m_gray.empty();
+    }
+
+  private:
+    void* push(void* p) noexcept
+    {
+      auto h = static_cast<gc_header*>(p);
+      h->mark = m_alloc_mark.load(std::memory_order_relaxed);
+      h->dead = 0;
+      h->next = m_head.load(std::memory_order_relaxed);
+      while (!m_head.compare_exchange_weak(
+        h->next, h, std::memory_order_release, std::memory_order_relaxed))
+        ;
+      return h + 1;
+    }
+
+  private:
+    std::atomic<gc_header*> m_head = nullptr;
+    std::atomic<uint32_t> m_alloc_mark = 0;
+    uint32_t m_epoch = 0;
+    std::mutex m_mtx;
+    std::vector<const void*> m_gray;
+  };
+
+  /// get collected heap
+  [[nodiscard]] inline gc_heap& get_gc_heap()
+  {
+    // never destroyed; objects can be released after static destructors.
+    static auto heap = new gc_heap();
+    return *heap;
+  }
+
+#endif
+
+} // namespace TORI_NS::detail
\ No newline at end of file
@@ -0,0 +1,209 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Per-type heap statistics
+///
+/// Define `TORI_ENABLE_HEAP_STATS` to count live objects and bytes of each
+/// object type. Objects are counted when created by make_object(), clone()
+/// or returned from code() as raw pointer, and uncounted when destroyed.
+/// When disabled, all hooks are empty and no counters are allocated.
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#endif
+
+#include <vector>
+
+#if defined(TORI_ENABLE_HEAP_STATS)
+#  include <mutex>
+#  include <atomic>
+#  include <memory>
+#  include <unordered_map>
+#endif
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    /// heap statistics of an object type
+    struct heap_record
+    {
+      /// type of object
+      object_ptr<const Type> type;
+      /// number of live objects
+      uint64_t live_objects = 0;
+      /// total size of live objects in bytes (excluding memory owned by
+      /// values)
+      uint64_t live_bytes = 0;
+    };
+
+    /// heap snapshot
+    struct heap_snapshot
+    {
+      /// records of object types
+      std::vector<heap_record> records;
+      /// number of live objects
+      uint64_t live_objects = 0;
+      /// total size of live objects in bytes
+      uint64_t live_bytes = 0;
+    };
+
+  } // namespace interface
+
+#if defined(TORI_ENABLE_HEAP_STATS)
+
+  /// counters of an object type
+  struct heap_stats_entry
+  {
+    /// number of shards
+    static constexpr size_t shards = 16;
+
+    /// counters updated by threads sharing this shard
+    struct alignas(64) shard
+    {
+      std::atomic<int64_t> objects = 0;
+      std::atomic<int64_t> bytes = 0;
+    };
+
+    /// info table
+    const object_info_table* info;
+    /// sharded counters
+    shard counters[shards];
+
+    /// get shard of current thread
+    shard& this_shard() noexcept
+    {
+      static std::atomic<size_t> next = 0;
+      thread_local size_t index =
+        next.fetch_add(1, std::memory_order_relaxed) % shards;
+      return counters[index];
+    }
+  };
+
+  /// global table of heap_stats_entry
+  class heap_stats_registry
+  {
+  public:
+    /// get (or create) entry of info table
+    [[nodiscard]] heap_stats_entry* get(const object_info_table* info)
+    {
+      std::lock_guard lock {m_mtx};
+      auto& e = m_entries[info];
+      if (!e) {
+        e = std::make_unique<heap_stats_entry>();
+        e->info = info;
+      }
+      return e.get();
+    }
+
+    /// call function on each entry
+    template <class F>
+    void for_each(F&& f)
+    {
+      std::lock_guard lock {m_mtx};
+      for (auto&& [info, e] : m_entries) {
+        (void)info;
+        f(*e);
+      }
+    }
+
+  private:
+    std::mutex m_mtx;
+    std::unordered_map<
+      const object_info_table*,
+      std::unique_ptr<heap_stats_entry>>
+      m_entries;
+  };
+
+  /// get heap stats registry
+  [[nodiscard]] inline heap_stats_registry& get_heap_stats_registry()
+  {
+    // never destroyed; objects can be released after static destructors.
+    static auto registry = new heap_stats_registry();
+    return *registry;
+  }
+
+  /// get entry of object type T
+  template <class T>
+  [[nodiscard]] heap_stats_entry& get_heap_stats_entry(const Object* obj)
+  {
+    static auto entry = get_heap_stats_registry().get(get_info_table(obj));
+    return *entry;
+  }
+
+  /// hook for new object
+  template <class T>
+  void heap_stats_add(const T* obj) noexcept
+  {
+    auto& refcount = obj->refcount;
+    // not owned by other pointers yet
+    if (refcount.load() != 1)
+      return;
+    refcount.set_heap_stats_flag();
+    auto& s = get_heap_stats_entry<T>(obj).this_shard();
+    s.objects.fetch_add(1, std::memory_order_relaxed);
+    s.bytes.fetch_add(
+      get_info_table(obj)->obj_size, std::memory_order_relaxed);
+  }
+
+  /// hook for destroyed object
+  template <class T>
+  void heap_stats_remove(const T* obj) noexcept
+  {
+    auto& refcount = obj->refcount;
+    if (!(refcount.load() & refcount.heap_stats_flag))
+      return;
+    auto& s = get_heap_stats_entry<T>(obj).this_shard();
+    s.objects.fetch_sub(1, std::memory_order_relaxed);
+    s.bytes.fetch_sub(
+      get_info_table(obj)->obj_size, std::memory_order_relaxed);
+  }
+
+#else
+
+  /// hook for new object (disabled)
+  template <class T>
+  void heap_stats_add(const T*) noexcept
+  {
+  }
+
+  /// hook for destroyed object (disabled)
+  template <class T>
+  void heap_stats_remove(const T*) noexcept
+  {
+  }
+
+#endif
+
+  namespace interface {
+
+    /// Get live objects and bytes of each object type.
+    /// \returns empty snapshot when heap statistics is disabled.
+    [[nodiscard]] inline heap_snapshot get_heap_stats()
+    {
+      heap_snapshot snapshot;
+#if defined(TORI_ENABLE_HEAP_STATS)
+      get_heap_stats_registry().for_each([&](heap_stats_entry& e) {
+        int64_t objects = 0;
+        int64_t bytes = 0;
+        for (auto&& s : e.counters) {
+          objects += s.objects.load(std::memory_order_relaxed);
+          bytes += s.bytes.load(std::memory_order_relaxed);
+        }
+        if (objects <= 0)
+          return;
+        snapshot.records.push_back(
+          {e.info->obj_type, uint64_t(objects), uint64_t(bytes)});
+        snapshot.live_objects += objects;
+        snapshot.live_bytes += bytes;
+      });
+#endif
+      return snapshot;
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
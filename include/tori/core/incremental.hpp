@@ -0,0 +1,305 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Incremental evaluation of apply graphs
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "apply.hpp"
+#  include "eval.hpp"
+#  include "gc.hpp"
+#endif
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    /// Apply graph which supports incremental re-evaluation.
+    ///
+    /// Inputs of each Apply node are kept in side table together with
+    /// dependency edges, so evaluated nodes can be restored to thunks.
+    /// Editing a node invalidates only the Apply nodes which depend on it,
+    /// and next eval() recomputes only that dirty cone since other nodes
+    /// still have their caches.
+    /// In gc mode the side table is a root set of the collector, since
+    /// evaluated nodes are only referenced from it.
+    /// \notes Not thread safe.
+    class incremental_graph
+    {
+    public:
+      /// Ctor
+      /// \param root root node of graph.
+      /// \notes Apply nodes already evaluated are treated as constants.
+      explicit incremental_graph(object_ptr<const Object> root)
+        : m_root {std::move(root)}
+      {
+        add_node(m_root);
+#if defined(TORI_ENABLE_GC)
+        get_gc_collector().add_root_set(this, visit_roots);
+        visit_roots(
+          this,
+          {[](const object_ptr_storage& obj, void*) {
+             gc_write_barrier(obj.get());
+           },
+           nullptr});
+#endif
+      }
+
+      /// Dtor
+      ~incremental_graph() noexcept
+      {
+#if defined(TORI_ENABLE_GC)
+        get_gc_collector().remove_root_set(this);
+#endif
+      }
+
+      incremental_graph(const incremental_graph&) = delete;
+      incremental_graph& operator=(const incremental_graph&) = delete;
+
+      /// get root
+      [[nodiscard]] const object_ptr<const Object>& root() const noexcept
+      {
+        return m_root;
+      }
+
+      /// evaluate root
+      [[nodiscard]] object_ptr<const Object> eval() const
+      {
+        return eval_impl(m_root);
+      }
+
+      /// number of tracked Apply nodes
+      [[nodiscard]] size_t node_count() const noexcept
+      {
+        return m_nodes.size();
+      }
+
+      /// number of evaluated Apply nodes invalidated since construction
+      [[nodiscard]] size_t invalidated_count() const noexcept
+      {
+        return m_invalidated;
+      }
+
+      /// replace argument of Apply node
+      void set_arg(
+        const object_ptr<const Object>& apply,
+        object_ptr<const Object> arg)
+      {
+        auto& n = get_node(apply);
+        replace_input(n.arg, std::move(arg), apply.get());
+      }
+
+      /// replace closure of Apply node
+      void set_app(
+        const object_ptr<const Object>& apply,
+        object_ptr<const Object> app)
+      {
+        auto& n = get_node(apply);
+        replace_input(n.app, std::move(app), apply.get());
+      }
+
+      /// Notify modification of a node.
+      /// Use this after modifying value of leaf objects in place.
+      void invalidate(const object_ptr<const Object>& obj)
+      {
+        if (m_nodes.count(obj.get()))
+          invalidate_node(obj.get());
+        else
+          invalidate_parents(obj.get());
+      }
+
+    private:
+      /// tracked Apply node
+      struct node_info
+      {
+        /// Apply object
+        object_ptr<const Apply> apply;
+        /// closure input
+        object_ptr<const Object> app;
+        /// argument input
+        object_ptr<const Object> arg;
+      };
+
+      node_info& get_node(const object_ptr<const Object>& apply)
+      {
+        auto it = m_nodes.find(apply.get());
+        if (TORI_UNLIKELY(it == m_nodes.end()))
+          throw std::invalid_argument(
+            "incremental_graph: not an Apply node of this graph");
+        return it->second;
+      }
+
+      /// replace input of node and forget detached subgraph
+      void replace_input(
+        object_ptr<const Object>& input,
+        object_ptr<const Object> obj,
+        const Object* node)
+      {
+        auto old = std::exchange(input, std::move(obj));
+#if defined(TORI_ENABLE_GC)
+        // root set is only visited at start of marking
+        gc_write_barrier(_get_storage(input).get());
+#endif
+        add_node(input);
+        add_edge(input, node);
+        remove_edge(old, node);
+        invalidate_node(node);
+        remove_subgraph(old);
+      }
+
+      /// register subgraph
+      void add_node(const object_ptr<const Object>& obj)
+      {
+        // inputs are stored in m_nodes which does not move on insertion
+        std::vector<const object_ptr<const Object>*> stack {&obj};
+
+        while (!stack.empty()) {
+          auto apply = value_cast_if<Apply>(*stack.back());
+          stack.pop_back();
+
+          if (!apply || m_nodes.count(apply.get()))
+            continue;
+
+          auto& storage = _get_storage(*apply);
+
+          if (storage.evaluated())
+            continue;
+
+          auto& n = m_nodes[apply.get()];
+          n = {apply, storage.app(), storage.arg()};
+
+          add_edge(n.app, apply.get());
+          add_edge(n.arg, apply.get());
+          stack.push_back(&n.arg);
+          stack.push_back(&n.app);
+        }
+      }
+
+      /// forget nodes which are no longer reachable from root
+      void remove_subgraph(const object_ptr<const Object>& obj)
+      {
+        // keep removed nodes alive until pointers in stack are checked
+        std::vector<node_info> removed;
+        std::vector<const Object*> stack;
+
+        if (obj)
+          stack.push_back(obj.get());
+
+        while (!stack.empty()) {
+          auto p = stack.back();
+          stack.pop_back();
+
+          if (p == m_root.get() || m_parents.count(p))
+            continue;
+
+          auto it = m_nodes.find(p);
+          if (it == m_nodes.end())
+            continue;
+
+          auto& n = removed.emplace_back(std::move(it->second));
+          m_nodes.erase(it);
+
+          remove_edge(n.app, p);
+          remove_edge(n.arg, p);
+          if (n.app)
+            stack.push_back(n.app.get());
+          if (n.arg)
+            stack.push_back(n.arg.get());
+        }
+      }
+
+      void add_edge(
+        const object_ptr<const Object>& child,
+        const Object* parent)
+      {
+        if (child)
+          m_parents[child.get()].push_back(parent);
+      }
+
+      void remove_edge(
+        const object_ptr<const Object>& child,
+        const Object* parent)
+      {
+        auto it = m_parents.find(child.get());
+        if (it == m_parents.end())
+          return;
+        auto& ps = it->second;
+        auto p = std::find(ps.begin(), ps.end(), parent);
+        if (p != ps.end())
+          ps.erase(p);
+        if (ps.empty())
+          m_parents.erase(it);
+      }
+
+      /// visit objects in side table
+      static void visit_roots(const void* graph, object_visitor visitor)
+      {
+        auto g = static_cast<const incremental_graph*>(graph);
+        visitor(g->m_root);
+        for (auto&& [p, n] : g->m_nodes) {
+          (void)p;
+          visitor(n.apply);
+          visitor(n.app);
+          visitor(n.arg);
+        }
+      }
+
+      /// restore node and its dependents
+      void invalidate_node(const Object* node)
+      {
+        std::unordered_set<const Object*> visited;
+        std::vector<const Object*> stack {node};
+
+        while (!stack.empty()) {
+          auto p = stack.back();
+          stack.pop_back();
+
+          if (!visited.insert(p).second)
+            continue;
+
+          if (auto it = m_nodes.find(p); it != m_nodes.end()) {
+            auto& n = it->second;
+            auto& storage = _get_storage(*n.apply);
+            if (storage.evaluated())
+              ++m_invalidated;
+            storage.reset(n.app, n.arg);
+          }
+
+          if (auto it = m_parents.find(p); it != m_parents.end()) {
+            for (auto&& parent : it->second) stack.push_back(parent);
+          }
+        }
+      }
+
+      /// restore dependents of a leaf
+      void invalidate_parents(const Object* leaf)
+      {
+        auto it = m_parents.find(leaf);
+        if (it == m_parents.end())
+          return;
+        for (auto&& p : it->second) invalidate_node(p);
+      }
+
+    private:
+      /// root
+      object_ptr<const Object> m_root;
+      /// Apply nodes
+      std::unordered_map<const Object*, node_info> m_nodes;
+      /// dependency edges (child -> parents)
+      std::unordered_map<const Object*, std::vector<const Object*>> m_parents;
+      /// statistics
+      size_t m_invalidated = 0;
+    };
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
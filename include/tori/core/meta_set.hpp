@@ -38,26 +38,51 @@ namespace TORI_NS::detail {
     }
   };
 
-  template <class... Ts1, class... Ts2>
-  constexpr auto
-    make_set_impl(meta_tuple<Ts1...> tuple, meta_tuple<Ts2...> rest)
+  /// index of first element which is same to T
+  template <class T, class... Ts>
+  constexpr size_t set_find_first()
   {
-    if constexpr (empty(rest))
-      return tuple;
-    else {
-      auto h = head(rest);
-      auto t = tail(rest);
-      if constexpr (contains(h, tuple))
-        return make_set_impl(tuple, t);
-      else
-        return make_set_impl(append(h, tuple), t);
+    constexpr bool same[] = {std::is_same_v<T, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i)
+      if (same[i])
+        return i;
+    return sizeof...(Ts);
+  }
+
+  /// concat helper for fold expression
+  template <class... Ts>
+  struct set_builder
+  {
+    template <class... Us>
+    constexpr auto operator+(set_builder<Us...>) const
+    {
+      return set_builder<Ts..., Us...> {};
     }
+
+    static constexpr auto tuple()
+    {
+      return tuple_c<Ts...>;
+    }
+  };
+
+  /// remove duplicates, keeping first occurrences in order
+  template <class... Ts, size_t... Is>
+  constexpr auto make_set_impl(meta_tuple<Ts...>, std::index_sequence<Is...>)
+  {
+    using result = decltype(
+      (set_builder<> {} + ... +
+       std::conditional_t<
+         set_find_first<Ts, Ts...>() == Is,
+         set_builder<Ts>,
+         set_builder<>> {}));
+    return result::tuple();
   }
 
   template <class... Ts>
   constexpr auto make_set(meta_tuple<Ts...> tuple)
   {
-    return meta_set_access::create(make_set_impl(tuple_c<>, tuple));
+    return meta_set_access::create(
+      make_set_impl(tuple, std::index_sequence_for<Ts...>()));
   }
 
   template <class T>
@@ -8,6 +8,8 @@
 #  include "meta_type.hpp"
 #endif
 
+#include <utility> // index_sequence
+
 namespace TORI_NS::detail {
 
   /// meta_tuple
@@ -59,20 +61,34 @@ namespace TORI_NS::detail {
   // ------------------------------------------
   // get
 
-  template <size_t It, size_t Idx, class H, class... Ts>
-  constexpr auto tuple_get_impl(meta_tuple<H, Ts...>)
+  /// element of tuple with index
+  template <size_t Idx, class T>
+  struct tuple_indexed
   {
-    if constexpr (It == Idx)
-      return type_c<H>;
-    else
-      return tuple_get_impl<It + 1, Idx>(tuple_c<Ts...>);
+  };
+
+  template <class Seq, class... Ts>
+  struct tuple_indexer;
+
+  /// inherits all elements so get() can find element by overload resolution
+  template <size_t... Is, class... Ts>
+  struct tuple_indexer<std::index_sequence<Is...>, Ts...>
+    : tuple_indexed<Is, Ts>...
+  {
+  };
+
+  template <size_t Idx, class T>
+  constexpr auto tuple_get_impl(tuple_indexed<Idx, T>)
+  {
+    return type_c<T>;
   }
 
   template <size_t Idx, class... Ts>
   constexpr auto get(meta_tuple<Ts...> tuple)
   {
     static_assert(Idx < tuple.size(), "Index out of range");
-    return tuple_get_impl<0, Idx>(tuple);
+    return tuple_get_impl<Idx>(
+      tuple_indexer<std::index_sequence_for<Ts...>, Ts...> {});
   }
 
   // ------------------------------------------
@@ -106,11 +122,8 @@ namespace TORI_NS::detail {
   {
     if constexpr (empty(t))
       static_assert(false_v<Ts...>, "Empty tuple");
-
-    if constexpr (t.size() <= 1)
-      return head(t);
     else
-      return last(tail(t));
+      return get<sizeof...(Ts) - 1>(t);
   }
 
   // ------------------------------------------
@@ -153,30 +166,33 @@ namespace TORI_NS::detail {
   // contains
 
   template <class E, class... Ts>
-  constexpr auto contains(meta_type<E> e, meta_tuple<Ts...> tuple)
+  constexpr auto contains(meta_type<E>, meta_tuple<Ts...>)
   {
-    (void)e;
-    (void)tuple;
-
-    if constexpr (empty(tuple)) {
-      return false_c;
-    } else if constexpr (e == head(tuple)) {
+    if constexpr ((std::is_same_v<E, Ts> || ...))
       return true_c;
-    } else {
-      return contains(e, tail(tuple));
-    }
+    else
+      return false_c;
   }
 
   // ------------------------------------------
   // remove_last
 
+  template <class... Ts, size_t... Is>
+  constexpr auto
+    remove_last_impl(meta_tuple<Ts...> tuple, std::index_sequence<Is...>)
+  {
+    (void)tuple;
+    return tuple_c<typename decltype(get<Is>(tuple))::type...>;
+  }
+
   template <class... Ts>
   constexpr auto remove_last(meta_tuple<Ts...> tuple)
   {
     if constexpr (tuple.size() <= 1)
       return tuple_c<>;
     else
-      return concat(make_tuple(head(tuple)), remove_last(tail(tuple)));
+      return remove_last_impl(
+        tuple, std::make_index_sequence<sizeof...(Ts) - 1>());
   }
 
 } // namespace TORI_NS::detail
\ No newline at end of file
@@ -21,6 +21,19 @@ namespace TORI_NS::detail {
   template <class T>
   static constexpr meta_type<T> type_c {};
 
+  template <class T>
+  struct meta_type_unwrap;
+
+  template <class T>
+  struct meta_type_unwrap<meta_type<T>>
+  {
+    using type = T;
+  };
+
+  /// get T from meta_type<T> (works on specializations without `type`)
+  template <class MetaType>
+  using meta_type_t = typename meta_type_unwrap<std::decay_t<MetaType>>::type;
+
   /// operator==
   template <class T1, class T2>
   constexpr auto operator==(meta_type<T1>, meta_type<T2>)
@@ -7,6 +7,7 @@
 #  include "../config/config.hpp"
 #  include "atomic.hpp"
 #  include "terms.hpp"
+#  include "gc_heap.hpp"
 #endif
 
 #include <cstdint>
@@ -29,6 +30,72 @@ namespace TORI_NS::detail {
   // object info table
   struct object_info_table;
 
+#if defined(TORI_ENABLE_PROFILER)
+  /// number of objects allocated by current thread (see profiler.hpp)
+  inline thread_local uint64_t profile_alloc_count = 0;
+#endif
+
+  // ------------------------------------------
+  // object_info_handle
+
+#if defined(TORI_COMPACT_HEADER)
+
+  /// Registry of info tables referenced from compact object headers.
+  /// Index 0 is reserved for null.
+  class info_table_registry
+  {
+  public:
+    /// maximum number of info tables
+    static constexpr uint32_t capacity = 1u << 16;
+
+    /// register info table
+    /// \throws std::length_error when registry is full.
+    [[nodiscard]] static uint32_t add(const object_info_table* info)
+    {
+      auto index = next.fetch_add(1, std::memory_order_relaxed);
+      if (TORI_UNLIKELY(index >= capacity))
+        throw std::length_error("info_table_registry: too many object types");
+      tables[index] = info;
+      return index;
+    }
+
+    /// get info table
+    [[nodiscard]] static const object_info_table* get(uint32_t index) noexcept
+    {
+      TORI_ASSERT(index < capacity);
+      return tables[index];
+    }
+
+  private:
+    static inline std::atomic<uint32_t> next = 1;
+    static inline const object_info_table* tables[capacity] = {};
+  };
+
+  /// 4byte index of info table in info_table_registry
+  using object_info_handle = uint32_t;
+
+  /// get handle of static info table
+  template <auto* Info>
+  [[nodiscard]] object_info_handle get_object_info_handle()
+  {
+    static const uint32_t index = info_table_registry::add(Info);
+    return index;
+  }
+
+#else
+
+  /// 8byte pointer to info table
+  using object_info_handle = const object_info_table*;
+
+  /// get handle of static info table
+  template <auto* Info>
+  [[nodiscard]] constexpr object_info_handle get_object_info_handle() noexcept
+  {
+    return Info;
+  }
+
+#endif
+
   // interface
   namespace interface {
 
@@ -45,13 +112,38 @@ namespace TORI_NS::detail {
     using Type = Box<type_object_value>;
 
     /// Base class of heap-allocated objects
-    struct Object
+    /// \notes object_ptr uses lowest 3 bits of address as pointer tag.
+    struct alignas(8) Object
     {
       /// term
       static constexpr auto term = type_c<tm_value<Object>>;
 
+#if defined(TORI_COMPACT_HEADER)
+
+      /// Ctor
+      constexpr Object(object_info_handle info)
+        : info_index {info}
+      {
+        /* Default initialize refcount */
+      }
+
+      /// Copy ctor
+      constexpr Object(const Object& other)
+        : info_index {other.info_index}
+      {
+        /* Default initialize refcount */
+      }
+
+      /// 4byte: reference count
+      mutable atomic_refcount<uint32_t> refcount = {1u};
+
+      /// 4byte: index of info table (see info_table_registry)
+      uint32_t info_index;
+
+#else
+
       /// Ctor
-      constexpr Object(const object_info_table* info)
+      constexpr Object(object_info_handle info)
         : info_table {info}
       {
         /* Default initialize refcount and spinlock */
@@ -75,10 +167,112 @@ namespace TORI_NS::detail {
 
       /// 8byte: pointer to info table
       const object_info_table* info_table;
+
+#endif
+
+#if defined(TORI_ENABLE_PROFILER) || defined(TORI_ENABLE_GC)
+      /// operator new (counts allocations, allocates on collected heap)
+      static void* operator new(std::size_t size)
+      {
+#  if defined(TORI_ENABLE_PROFILER)
+        ++profile_alloc_count;
+#  endif
+#  if defined(TORI_ENABLE_GC)
+        return get_gc_heap().allocate(size);
+#  else
+        return ::operator new(size);
+#  endif
+      }
+
+      /// operator new (counts allocations, allocates on collected heap)
+      static void*
+        operator new(std::size_t size, const std::nothrow_t&) noexcept
+      {
+#  if defined(TORI_ENABLE_PROFILER)
+        ++profile_alloc_count;
+#  endif
+#  if defined(TORI_ENABLE_GC)
+        return get_gc_heap().allocate(size, std::nothrow);
+#  else
+        return ::operator new(size, std::nothrow);
+#  endif
+      }
+
+      /// operator delete
+      static void operator delete(void* p) noexcept
+      {
+#  if defined(TORI_ENABLE_GC)
+        get_gc_heap().deallocate(p);
+#  else
+        ::operator delete(p);
+#  endif
+      }
+
+      /// operator delete
+      static void operator delete(void* p, const std::nothrow_t&) noexcept
+      {
+#  if defined(TORI_ENABLE_GC)
+        get_gc_heap().deallocate(p);
+#  else
+        ::operator delete(p);
+#  endif
+      }
+#endif
     };
 
     static_assert(std::is_standard_layout_v<Object>);
 
   } // namespace interface
 
+  // ------------------------------------------
+  // header access
+
+  /// get info table of object
+  [[nodiscard]] inline const object_info_table*
+    get_info_table(const Object* obj) noexcept
+  {
+#if defined(TORI_COMPACT_HEADER)
+    return info_table_registry::get(obj->info_index);
+#else
+    return obj->info_table;
+#endif
+  }
+
+#if defined(TORI_ENABLE_GC)
+
+  /// Write barrier of incremental collector.
+  /// Marks object which is about to be unlinked from graph while marking is
+  /// in progress, so objects reachable at start of marking are not swept.
+  inline void gc_write_barrier(const Object* obj)
+  {
+    auto& heap = get_gc_heap();
+    if (TORI_LIKELY(!heap.marking()) || !obj || obj->refcount.load() == 0)
+      return;
+    std::lock_guard lock {heap.mark_mutex()};
+    if (heap.marking())
+      heap.shade(obj);
+  }
+
+#endif
+
+  /// get spinlock of object
+  /// \notes compact header does not have spinlock, so objects share striped
+  /// locks selected by address.
+  [[nodiscard]] inline atomic_spinlock<uint8_t>&
+    get_object_spinlock(const Object* obj) noexcept
+  {
+#if defined(TORI_COMPACT_HEADER)
+    struct alignas(64) stripe
+    {
+      atomic_spinlock<uint8_t> lock;
+    };
+    static stripe stripes[64];
+    auto h = reinterpret_cast<uintptr_t>(obj) >> 4;
+    h ^= h >> 7;
+    return stripes[h % 64].lock;
+#else
+    return obj->spinlock;
+#endif
+  }
+
 } // namespace TORI_NS::detail
\ No newline at end of file
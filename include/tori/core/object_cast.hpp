@@ -14,9 +14,10 @@ namespace TORI_NS::detail {
   template <class T, class U>
   [[nodiscard]] object_ptr<T> static_object_cast(const object_ptr<U>& obj)
   {
-    // add refcount
-    if (TORI_LIKELY(obj && !obj.is_static()))
-      _get_storage(obj).head()->refcount.fetch_add();
+    // add refcount (objects are released by collector in gc mode)
+    if constexpr (!gc_enabled)
+      if (TORI_LIKELY(obj && !obj.is_static()))
+        _get_storage(obj).head()->refcount.fetch_add();
 
     if constexpr (std::is_base_of_v<U, T> && sizeof(T) == sizeof(U))
       // downcast to proxy types (empty derived class from Object) using
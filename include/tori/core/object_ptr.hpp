@@ -7,6 +7,7 @@
 #  include "../config/config.hpp"
 #  include "object.hpp"
 #  include "object_ptr_storage.hpp"
+#  include "weak_reference.hpp"
 #endif
 
 namespace TORI_NS::detail {
@@ -197,6 +198,34 @@ namespace TORI_NS::detail {
 
   } // namespace interface
 
+  // hook for new object (defined in heap_stats.hpp)
+  template <class T>
+  void heap_stats_add(const T* obj) noexcept;
+
+  // hook for object in block of compact() (defined in compact.hpp)
+  template <class T>
+  void compact_arena_release(const T* obj) noexcept;
+
+  // ------------------------------------------
+  // object_visitor
+
+  /// Callback for objects owned by other object
+  struct object_visitor
+  {
+    /// function. receives storage of non-null object_ptr.
+    void (*func)(const object_ptr_storage&, void*);
+    /// context of function
+    void* ctx;
+
+    /// visit object
+    template <class T>
+    void operator()(const object_ptr<T>& obj) const
+    {
+      if (_get_storage(obj).get())
+        func(_get_storage(obj), ctx);
+    }
+  };
+
   // ------------------------------------------
   // object_info_table
 
@@ -211,6 +240,12 @@ namespace TORI_NS::detail {
     void (*destroy)(const Object*) noexcept;
     /// vtable of clone function
     Object* (*clone)(const Object*)noexcept;
+    /// vtable of function to visit objects owned by object
+    void (*visit)(const Object*, object_visitor) noexcept;
+    /// vtable of function to copy object into given memory
+    Object* (*clone_at)(const Object*, void*) noexcept;
+    /// vtable of function to destroy object without releasing memory
+    void (*finalize)(const Object*) noexcept;
   };
 
   // ------------------------------------------
@@ -218,10 +253,23 @@ namespace TORI_NS::detail {
 
   void object_ptr_storage::decrement_refcount() noexcept
   {
+    // objects are released by collector in gc mode
+    if constexpr (gc_enabled)
+      return;
+
     if (TORI_LIKELY(get() && !is_static())) {
-      if (head()->refcount.fetch_sub() == 1) {
+      auto& refcount = head()->refcount;
+      auto count = refcount.fetch_sub();
+      if ((count & refcount.count_mask) == 1) {
         std::atomic_thread_fence(std::memory_order_acquire);
-        info_table()->destroy(get());
+        // detach weak references
+        if (TORI_UNLIKELY(count & refcount.weak_flag))
+          get_weak_reference_table().expire(get());
+        // not allocated on heap
+        if (TORI_UNLIKELY(count & refcount.arena_flag))
+          compact_arena_release(get());
+        else
+          info_table()->destroy(get());
       }
     }
   }
@@ -322,7 +370,10 @@ namespace TORI_NS::detail {
     template <class T, class... Args>
     [[nodiscard]] auto make_object(Args&&... args)
     {
-      return object_ptr<T>(new T(std::forward<Args>(args)...));
+      auto p = new T(std::forward<Args>(args)...);
+      if constexpr (heap_stats_enabled)
+        heap_stats_add(p);
+      return object_ptr<T>(p);
     }
 
   } // namespace interface
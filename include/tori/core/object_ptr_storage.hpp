@@ -91,7 +91,7 @@ namespace TORI_NS::detail {
     const object_info_table* info_table() const noexcept
     {
       TORI_ASSERT(get());
-      return head()->info_table;
+      return get_info_table(head());
     }
 
     /// apply? (optional)
@@ -117,14 +117,16 @@ namespace TORI_NS::detail {
     uint64_t use_count() const noexcept
     {
       TORI_ASSERT(get());
-      return head()->refcount.load();
+      return head()->refcount.load() & head()->refcount.count_mask;
     }
 
     /// increment refcount
     void increment_refcount() noexcept
     {
-      if (TORI_LIKELY(get() && !is_static()))
-        head()->refcount.fetch_add();
+      // objects are released by collector in gc mode
+      if constexpr (!gc_enabled)
+        if (TORI_LIKELY(get() && !is_static()))
+          head()->refcount.fetch_add();
     }
 
     /// decrement refcount
@@ -0,0 +1,191 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#  include "object_cast.hpp"
+#endif
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    // ------------------------------------------
+    // object_ref
+
+    /// Non-owning pointer to heap-allocated object.
+    ///
+    /// Borrows object from `object_ptr` without touching reference count, so
+    /// reading arguments and subgraphs within a call does no atomic RMW.
+    /// Converting back to `object_ptr` takes a new reference.
+    /// \notes Referenced object should outlive object_ref. Do not borrow from
+    /// temporary object_ptr unless it lives until end of the use.
+    template <class T = Object>
+    class object_ref
+    {
+      // internal storage access
+      template <class U>                             //
+      friend const object_ptr_storage&               //
+        _get_storage(const object_ref<U>&) noexcept; //
+
+    public:
+      // value type
+      using element_type = T;
+      // pointer
+      using pointer = T*;
+
+      /// Constructor
+      constexpr object_ref() noexcept
+        : m_storage {nullptr}
+      {
+      }
+
+      /// Constructor
+      constexpr object_ref(nullptr_t) noexcept
+        : m_storage {nullptr}
+      {
+      }
+
+      /// Pointer constructor
+      constexpr object_ref(pointer p) noexcept
+        : m_storage {p}
+      {
+      }
+
+      /// Borrow from object_ptr
+      template <
+        class U,
+        class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+      object_ref(const object_ptr<U>& other) noexcept
+        : m_storage {_get_storage(other)}
+      {
+      }
+
+      /// Convert constructor
+      template <
+        class U,
+        class = std::enable_if_t<
+          !std::is_same_v<U, T> && std::is_convertible_v<U*, T*>>>
+      object_ref(const object_ref<U>& other) noexcept
+        : m_storage {_get_storage(other)}
+      {
+      }
+
+      /// Take new reference
+      /// \effects increases reference count.
+      template <
+        class U,
+        class = std::enable_if_t<std::is_convertible_v<T*, U*>>>
+      operator object_ptr<U>() const noexcept
+      {
+        object_ptr<U> ret;
+        _get_storage(ret) = m_storage;
+        _get_storage(ret).increment_refcount();
+        return ret;
+      }
+
+      /// get address of object
+      [[nodiscard]] pointer get() const noexcept
+      {
+        return reinterpret_cast<pointer>(
+          const_cast<propagate_const_t<Object*, pointer>>(m_storage.get()));
+      }
+
+      /// get address of member `value`
+      /// \requires not null.
+      [[nodiscard]] auto* value() const noexcept
+      {
+        TORI_ASSERT(get());
+        return &get()->value;
+      }
+
+      /// operator bool
+      [[nodiscard]] explicit operator bool() const noexcept
+      {
+        return m_storage.get() != nullptr;
+      }
+
+      /// use_count
+      /// \requires not null.
+      [[nodiscard]] uint64_t use_count() const noexcept
+      {
+        return m_storage.use_count();
+      }
+
+      /// is_static
+      /// \requires not null.
+      [[nodiscard]] bool is_static() const noexcept
+      {
+        return m_storage.is_static();
+      }
+
+      /// operator*
+      [[nodiscard]] auto& operator*() const noexcept
+      {
+        return *value();
+      }
+
+      /// operator->
+      [[nodiscard]] auto* operator-> () const noexcept
+      {
+        return value();
+      }
+
+    private:
+      /// pointer to object
+      object_ptr_storage m_storage;
+    };
+
+    // ------------------------------------------
+    // operators
+
+    /// operator==
+    template <class T, class U>
+    [[nodiscard]] bool
+      operator==(const object_ref<T>& lhs, const object_ref<U>& rhs) noexcept
+    {
+      return _get_storage(lhs).get() == _get_storage(rhs).get();
+    }
+
+    /// operator!=
+    template <class T, class U>
+    [[nodiscard]] bool
+      operator!=(const object_ref<T>& lhs, const object_ref<U>& rhs) noexcept
+    {
+      return _get_storage(lhs).get() != _get_storage(rhs).get();
+    }
+
+    // ------------------------------------------
+    // storage access
+
+    /// internal storage accessor
+    template <class U>
+    [[nodiscard]] const object_ptr_storage& //
+      _get_storage(const object_ref<U>& obj) noexcept
+    {
+      return obj.m_storage;
+    }
+
+    // ------------------------------------------
+    // deduction guides
+
+    template <class T>
+    object_ref(const object_ptr<T>&)->object_ref<T>;
+
+  } // namespace interface
+
+  /// static object cast
+  template <class T, class U>
+  [[nodiscard]] object_ref<T> static_object_cast(const object_ref<U>& obj)
+  {
+    if constexpr (std::is_base_of_v<U, T> && sizeof(T) == sizeof(U))
+      // see static_object_cast(const object_ptr<U>&)
+      return reinterpret_cast<T*>(obj.get());
+    else
+      return static_cast<T*>(obj.get());
+  }
+
+} // namespace TORI_NS::detail
\ No newline at end of file
@@ -0,0 +1,86 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Object size estimation
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "box.hpp"
+#  include "object_ref.hpp"
+#endif
+
+#include <mutex>
+#include <unordered_map>
+
+namespace TORI_NS::detail {
+
+  /// Functions which return size of memory owned by values of objects,
+  /// indexed by info table.
+  class heap_size_registry
+  {
+  public:
+    /// heap size function
+    using function_type = size_t (*)(const Object*) noexcept;
+
+    /// add function
+    void add(const object_info_table* info, function_type f)
+    {
+      std::lock_guard lock {m_mtx};
+      m_functions.emplace(info, f);
+    }
+
+    /// find function
+    [[nodiscard]] function_type find(const object_info_table* info) const
+    {
+      std::lock_guard lock {m_mtx};
+      auto it = m_functions.find(info);
+      return it == m_functions.end() ? nullptr : it->second;
+    }
+
+  private:
+    mutable std::mutex m_mtx;
+    std::unordered_map<const object_info_table*, function_type> m_functions;
+  };
+
+  /// global heap size registry
+  [[nodiscard]] inline heap_size_registry& get_heap_size_registry()
+  {
+    static heap_size_registry registry;
+    return registry;
+  }
+
+  namespace interface {
+
+    /// Register heap size of Box<T>.
+    /// `T` should have `size_t heap_size() const noexcept` which returns size
+    /// of memory owned by the value.
+    /// \returns true (for static initialization)
+    template <class T>
+    bool register_heap_size()
+    {
+      get_heap_size_registry().add(
+        &T::info_table_initializer::info_table,
+        [](const Object* obj) noexcept {
+          return static_cast<const T*>(obj)->value.heap_size();
+        });
+      return true;
+    }
+
+    /// Estimated size of object in bytes, including memory owned by its
+    /// value when registered by register_heap_size().
+    [[nodiscard]] inline size_t object_size(object_ref<const Object> obj)
+    {
+      if (!obj)
+        return 0;
+      auto info = get_info_table(obj.get());
+      auto size = static_cast<size_t>(info->obj_size);
+      if (auto f = get_heap_size_registry().find(info))
+        size += f(obj.get());
+      return size;
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
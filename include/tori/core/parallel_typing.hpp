@@ -0,0 +1,200 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Parallel type inference
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "dynamic_typing.hpp"
+#  include "type_error.hpp"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace TORI_NS::detail {
+
+  /// Splits graph into independent subtrees and infers them on threads.
+  /// Apply nodes above subtrees are unified on the calling thread after all
+  /// subtrees are typed.
+  class parallel_type_inference
+  {
+  public:
+    parallel_type_inference(size_t threads, size_t grain)
+      : m_threads {threads ? threads : std::thread::hardware_concurrency()}
+      , m_grain {std::max<size_t>(grain, 1)}
+    {
+    }
+
+    [[nodiscard]] object_ptr<const Type>
+      run(const object_ptr<const Object>& obj)
+    {
+      count(obj);
+      auto root = build(obj, 0);
+      m_sizes = {};
+
+      if (m_tasks.size() == 1)
+        return type_of_func_impl(m_tasks[0]);
+
+      infer_tasks();
+      return resolve(root);
+    }
+
+  private:
+    /// Count nodes visited by sequential inference in pre-order.
+    /// Shared nodes are counted for each occurrence, so subtree of the node
+    /// at index `i` occupies `[i, i + m_sizes[i])`.
+    void count(const object_ptr<const Object>& obj)
+    {
+      auto idx = m_sizes.size();
+      m_sizes.push_back(1);
+
+      auto apply = value_cast_if<const Apply>(obj);
+      if (!apply || _get_storage(*apply).evaluated())
+        return;
+
+      count(_get_storage(*apply).app());
+      count(_get_storage(*apply).arg());
+      m_sizes[idx] = m_sizes.size() - idx;
+    }
+
+    /// Build plan. Returns index of plan node.
+    size_t build(const object_ptr<const Object>& obj, size_t pos)
+    {
+      auto idx = m_plan.size();
+
+      if (m_sizes[pos] > m_grain) {
+        // only unevaluated Apply has children
+        auto apply = static_object_cast<const Apply>(obj);
+        m_plan.push_back({apply, 0, 0});
+        auto app_pos = pos + 1;
+        auto arg_pos = app_pos + m_sizes[app_pos];
+        auto app = build(_get_storage(*apply).app(), app_pos);
+        auto arg = build(_get_storage(*apply).arg(), arg_pos);
+        m_plan[idx].app = app;
+        m_plan[idx].arg = arg;
+      } else {
+        m_plan.push_back({nullptr, m_tasks.size(), 0});
+        m_tasks.push_back(obj);
+      }
+      return idx;
+    }
+
+    /// Infer types of subtrees.
+    void infer_tasks()
+    {
+      auto n = m_tasks.size();
+
+      m_results.resize(n);
+      m_errors.resize(n);
+
+      std::atomic<size_t> next = {0};
+
+      auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < n;) {
+          try {
+            m_results[i] = type_of_func_impl(m_tasks[i]);
+          } catch (...) {
+            m_errors[i] = std::current_exception();
+          }
+        }
+      };
+
+      std::vector<std::thread> threads;
+      auto n_threads = std::min(m_threads, n);
+      for (size_t i = 1; i < n_threads; ++i)
+        threads.emplace_back(worker);
+      worker();
+      for (auto&& t : threads)
+        t.join();
+
+      // report error of leftmost subtree
+      for (auto&& e : m_errors)
+        if (e)
+          std::rethrow_exception(e);
+    }
+
+    /// Unify results of subtrees.
+    object_ptr<const Type> resolve(size_t idx)
+    {
+      auto& node = m_plan[idx];
+
+      if (!node.apply)
+        return m_results[node.app];
+
+      auto _t1 = resolve(node.app);
+      auto _t2 = resolve(node.arg);
+      auto _t = genvar();
+      auto c =
+        std::vector {Constr {_t1, make_object<Type>(arrow_type {_t2, _t})}};
+      auto s = unify(std::move(c), node.apply);
+      return subst_type_all(s, _t);
+    }
+
+  private:
+    /// node of plan
+    struct plan_node
+    {
+      /// Apply node to unify, or null for subtree
+      object_ptr<const Apply> apply;
+      /// index of app node, or index of subtree
+      size_t app;
+      /// index of arg node
+      size_t arg;
+    };
+
+    /// number of threads
+    size_t m_threads;
+    /// max size of subtree
+    size_t m_grain;
+    /// pre-order subtree sizes
+    std::vector<size_t> m_sizes;
+    /// plan
+    std::vector<plan_node> m_plan;
+    /// subtrees
+    std::vector<object_ptr<const Object>> m_tasks;
+    /// types of subtrees
+    std::vector<object_ptr<const Type>> m_results;
+    /// errors of subtrees
+    std::vector<std::exception_ptr> m_errors;
+  };
+
+  namespace interface {
+
+    /// Parallel version of type_of().
+    /// Subtrees which have at most `grain` nodes are inferred on `threads`
+    /// threads, then unified on the calling thread.
+    /// \param threads number of threads. 0 to use hardware concurrency.
+    /// \param grain max number of nodes inferred in single task.
+    /// \notes Result is equal to type_of() up to names of type variables.
+    [[nodiscard]] inline object_ptr<const Type> type_of_parallel(
+      const object_ptr<const Object>& obj,
+      size_t threads = 0,
+      size_t grain = 1024)
+    {
+      parallel_type_inference inference {threads, grain};
+      return inference.run(obj);
+    }
+
+    /// Parallel version of check_type().
+    /// \throws type_error::bad_type_check when type does not match.
+    template <class T>
+    void check_type_parallel(
+      const object_ptr<const Object>& obj,
+      size_t threads = 0,
+      size_t grain = 1024)
+    {
+      auto t1 = object_type<T>();
+      auto t2 = type_of_parallel(obj, threads, grain);
+      if (TORI_UNLIKELY(!same_type(t1, t2)))
+        throw type_error::bad_type_check(t1, t2, obj);
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
@@ -0,0 +1,304 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Per-closure profiling counters
+///
+/// Define `TORI_ENABLE_PROFILER` to enable profiler. When disabled, all hooks
+/// are empty and no counters are allocated.
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#endif
+
+#include <vector>
+
+#if defined(TORI_ENABLE_PROFILER)
+#  include <mutex>
+#  include <memory>
+#  include <atomic>
+#  include <chrono>
+#  include <unordered_map>
+#endif
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    /// profile counters of a closure type
+    struct profile_counters
+    {
+      /// number of calls to code()
+      uint64_t calls = 0;
+      /// time spent in code() including nested calls (ns)
+      uint64_t inclusive_ns = 0;
+      /// time spent in code() excluding nested calls (ns)
+      uint64_t exclusive_ns = 0;
+      /// number of exceptions returned from code()
+      uint64_t exceptions = 0;
+      /// number of objects allocated in code() (excluding nested calls)
+      uint64_t allocations = 0;
+      /// number of apply cache misses which called this closure
+      uint64_t cache_misses = 0;
+    };
+
+    /// profile record
+    struct profile_record
+    {
+      /// type of closure
+      object_ptr<const Type> type;
+      /// counters
+      profile_counters counters;
+    };
+
+    /// profile snapshot
+    struct profile_snapshot
+    {
+      /// records of closure types
+      std::vector<profile_record> records;
+      /// number of apply cache hits in eval
+      uint64_t cache_hits = 0;
+      /// number of apply cache misses in eval
+      uint64_t cache_misses = 0;
+    };
+
+  } // namespace interface
+
+#if defined(TORI_ENABLE_PROFILER)
+
+  /// counters updated by owner thread and read by others
+  struct profile_entry
+  {
+    std::atomic<uint64_t> calls = 0;
+    std::atomic<uint64_t> inclusive_ns = 0;
+    std::atomic<uint64_t> exclusive_ns = 0;
+    std::atomic<uint64_t> exceptions = 0;
+    std::atomic<uint64_t> allocations = 0;
+    std::atomic<uint64_t> cache_misses = 0;
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t n) noexcept
+    {
+      // single writer
+      counter.store(
+        counter.load(std::memory_order_relaxed) + n,
+        std::memory_order_relaxed);
+    }
+  };
+
+  /// call frame of code()
+  struct profile_frame
+  {
+    /// start time
+    std::chrono::steady_clock::time_point start;
+    /// time spent in nested calls
+    uint64_t child_ns;
+    /// allocation count at start
+    uint64_t alloc_start;
+    /// allocations in nested calls
+    uint64_t child_allocs;
+  };
+
+  /// thread local profile data
+  struct profile_thread_data
+  {
+    /// lock for entries (insertion and snapshot)
+    std::mutex mtx;
+    /// entries
+    std::unordered_map<const object_info_table*, profile_entry> entries;
+    /// cache hits
+    std::atomic<uint64_t> cache_hits = 0;
+    /// cache misses
+    std::atomic<uint64_t> cache_misses = 0;
+    /// call stack (owner thread only)
+    std::vector<profile_frame> frames;
+
+    profile_entry& get(const object_info_table* info)
+    {
+      // fast path: owner thread is the only writer of the map
+      if (auto it = entries.find(info); TORI_LIKELY(it != entries.end()))
+        return it->second;
+      std::lock_guard lock {mtx};
+      return entries[info];
+    }
+  };
+
+  /// global list of thread data
+  struct profile_registry
+  {
+    std::mutex mtx;
+    std::vector<std::shared_ptr<profile_thread_data>> threads;
+
+    static profile_registry& get()
+    {
+      static profile_registry registry;
+      return registry;
+    }
+  };
+
+  /// get thread data of current thread
+  [[nodiscard]] inline profile_thread_data& profile_this_thread()
+  {
+    thread_local auto data = [] {
+      auto d = std::make_shared<profile_thread_data>();
+      auto& r = profile_registry::get();
+      std::lock_guard lock {r.mtx};
+      r.threads.push_back(d);
+      return d;
+    }();
+    return *data;
+  }
+
+  /// RAII hook for vtbl_code_func
+  class profile_code_scope
+  {
+  public:
+    explicit profile_code_scope(const object_info_table* info) noexcept
+      : m_info {info}
+      , m_data {profile_this_thread()}
+    {
+      m_data.frames.push_back(
+        {std::chrono::steady_clock::now(), 0, profile_alloc_count, 0});
+    }
+
+    /// mark exception
+    void exception() noexcept
+    {
+      m_exception = true;
+    }
+
+    ~profile_code_scope() noexcept
+    {
+      auto end = std::chrono::steady_clock::now();
+      auto frame = m_data.frames.back();
+      m_data.frames.pop_back();
+
+      auto inclusive = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          end - frame.start)
+          .count());
+      auto allocs = profile_alloc_count - frame.alloc_start;
+
+      if (!m_data.frames.empty()) {
+        m_data.frames.back().child_ns += inclusive;
+        m_data.frames.back().child_allocs += allocs;
+      }
+
+      auto& e = m_data.get(m_info);
+      profile_entry::add(e.calls, 1);
+      profile_entry::add(e.inclusive_ns, inclusive);
+      profile_entry::add(e.exclusive_ns, inclusive - frame.child_ns);
+      profile_entry::add(e.allocations, allocs - frame.child_allocs);
+      if (m_exception)
+        profile_entry::add(e.exceptions, 1);
+    }
+
+  private:
+    const object_info_table* m_info;
+    profile_thread_data& m_data;
+    bool m_exception = false;
+  };
+
+  /// hook for apply cache hit
+  inline void profile_cache_hit() noexcept
+  {
+    profile_entry::add(profile_this_thread().cache_hits, 1);
+  }
+
+  /// hook for apply cache miss
+  inline void profile_cache_miss(const object_info_table* info) noexcept
+  {
+    auto& data = profile_this_thread();
+    profile_entry::add(data.cache_misses, 1);
+    profile_entry::add(data.get(info).cache_misses, 1);
+  }
+
+#else
+
+  /// RAII hook for vtbl_code_func (disabled)
+  class profile_code_scope
+  {
+  public:
+    explicit profile_code_scope(const object_info_table*) noexcept
+    {
+    }
+
+    void exception() noexcept
+    {
+    }
+  };
+
+  /// hook for apply cache hit (disabled)
+  inline void profile_cache_hit() noexcept
+  {
+  }
+
+  /// hook for apply cache miss (disabled)
+  inline void profile_cache_miss(const object_info_table*) noexcept
+  {
+  }
+
+#endif
+
+  namespace interface {
+
+    /// Merge counters of all threads.
+    /// \returns empty snapshot when profiler is disabled.
+    [[nodiscard]] inline profile_snapshot get_profile()
+    {
+      profile_snapshot snapshot;
+#if defined(TORI_ENABLE_PROFILER)
+      std::unordered_map<const object_info_table*, profile_counters> merged;
+
+      auto& r = profile_registry::get();
+      std::lock_guard lock {r.mtx};
+
+      for (auto&& t : r.threads) {
+        std::lock_guard tlock {t->mtx};
+        snapshot.cache_hits += t->cache_hits.load(std::memory_order_relaxed);
+        snapshot.cache_misses +=
+          t->cache_misses.load(std::memory_order_relaxed);
+        for (auto&& [info, e] : t->entries) {
+          auto& c = merged[info];
+          c.calls += e.calls.load(std::memory_order_relaxed);
+          c.inclusive_ns += e.inclusive_ns.load(std::memory_order_relaxed);
+          c.exclusive_ns += e.exclusive_ns.load(std::memory_order_relaxed);
+          c.exceptions += e.exceptions.load(std::memory_order_relaxed);
+          c.allocations += e.allocations.load(std::memory_order_relaxed);
+          c.cache_misses += e.cache_misses.load(std::memory_order_relaxed);
+        }
+      }
+
+      for (auto&& [info, c] : merged)
+        snapshot.records.push_back({info->obj_type, c});
+#endif
+      return snapshot;
+    }
+
+    /// Reset counters of all threads.
+    inline void reset_profile()
+    {
+#if defined(TORI_ENABLE_PROFILER)
+      auto& r = profile_registry::get();
+      std::lock_guard lock {r.mtx};
+      for (auto&& t : r.threads) {
+        std::lock_guard tlock {t->mtx};
+        t->cache_hits = 0;
+        t->cache_misses = 0;
+        for (auto&& [info, e] : t->entries) {
+          (void)info;
+          e.calls = 0;
+          e.inclusive_ns = 0;
+          e.exclusive_ns = 0;
+          e.exceptions = 0;
+          e.allocations = 0;
+          e.cache_misses = 0;
+        }
+      }
+#endif
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
@@ -0,0 +1,1059 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Binary serialization of object graphs
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "box.hpp"
+#  include "type_gen.hpp"
+#  include "dynamic_typing.hpp"
+#  include "string.hpp"
+#  include "apply.hpp"
+#  include "function.hpp"
+#  include "exception.hpp"
+#endif
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define TORI_HAS_MMAP 1
+#endif
+
+namespace TORI_NS::detail {
+
+  // ------------------------------------------
+  // Errors
+
+  namespace interface {
+
+    /// serialization error
+    class serialize_error : public std::runtime_error
+    {
+    public:
+      explicit serialize_error(const std::string& msg)
+        : std::runtime_error("serialize_error: " + msg)
+      {
+      }
+    };
+
+  } // namespace interface
+
+  // ------------------------------------------
+  // File format
+  //
+  // All values are stored in native byte order and every record is aligned
+  // to 8 bytes.
+  //
+  //  [archive_header]
+  //  [record]...            : one record per unique node
+  //  [uint64_t offsets[N]]  : offset of each record from file head
+  //  [uint64_t roots[R]]    : node index of each root
+  //
+  // A record starts with `archive_record_header` followed by payload.
+  // References to other nodes are stored as node index (`archive_null_node`
+  // for null pointers), so shared nodes are written exactly once. Records
+  // are written in post order, so references always point to smaller index.
+
+  /// magic number
+  constexpr char archive_magic[8] = {'T', 'O', 'R', 'I', 'G', 'R', 'P', 'H'};
+  /// format version
+  constexpr uint32_t archive_version = 1;
+  /// null reference
+  constexpr uint64_t archive_null_node = ~uint64_t(0);
+
+  /// record kinds
+  enum class archive_record_kind : uint32_t
+  {
+    apply = 1,      //< [app][arg]
+    box = 2,        //< [name][payload]
+    closure = 3,    //< [name][n_args][arity][args...]
+    type_value = 4, //< [name]
+    type_arrow = 5, //< [captured][returns]
+    type_var = 6,   //< [id]
+  };
+
+  /// file header
+  struct archive_header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t node_count;
+    uint64_t root_count;
+    uint64_t offset_table;
+    uint64_t root_table;
+  };
+
+  /// record header
+  struct archive_record_header
+  {
+    archive_record_kind kind;
+    /// payload size
+    uint32_t size;
+  };
+
+  static_assert(sizeof(archive_header) == 48);
+  static_assert(sizeof(archive_record_header) == 8);
+
+  // ------------------------------------------
+  // archive_writer
+
+  /// Byte buffer for building archive
+  class archive_buffer
+  {
+  public:
+    /// current offset
+    [[nodiscard]] uint64_t size() const noexcept
+    {
+      return m_bytes.size();
+    }
+
+    /// write raw bytes
+    void write(const void* data, size_t size)
+    {
+      auto p = static_cast<const std::byte*>(data);
+      m_bytes.insert(m_bytes.end(), p, p + size);
+    }
+
+    /// write trivially copyable value
+    template <class T>
+    void write(const T& v)
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+      write(&v, sizeof(T));
+    }
+
+    /// write length-prefixed string
+    void write_string(const char* str)
+    {
+      auto len = static_cast<uint32_t>(std::strlen(str));
+      write(len);
+      write(str, len + 1);
+    }
+
+    /// pad to 8 byte boundary
+    void align()
+    {
+      m_bytes.resize((m_bytes.size() + 7) & ~size_t(7));
+    }
+
+    /// overwrite trivially copyable value at offset
+    template <class T>
+    void write_at(uint64_t offset, const T& v)
+    {
+      std::memcpy(m_bytes.data() + offset, &v, sizeof(T));
+    }
+
+    /// get bytes
+    [[nodiscard]] std::vector<std::byte>&& bytes() && noexcept
+    {
+      return std::move(m_bytes);
+    }
+
+  private:
+    std::vector<std::byte> m_bytes;
+  };
+
+  // ------------------------------------------
+  // archive_reader
+
+  /// Bounds checked view of a record
+  class archive_reader
+  {
+  public:
+    archive_reader(const std::byte* data, size_t size) noexcept
+      : m_data {data}
+      , m_size {size}
+      , m_pos {0}
+    {
+    }
+
+    /// read raw bytes
+    [[nodiscard]] const std::byte* read(size_t size)
+    {
+      if (TORI_UNLIKELY(size > m_size - m_pos))
+        throw serialize_error("record overrun");
+      auto p = m_data + m_pos;
+      m_pos += size;
+      return p;
+    }
+
+    /// read trivially copyable value
+    template <class T>
+    [[nodiscard]] T read()
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+      T v;
+      std::memcpy(&v, read(sizeof(T)), sizeof(T));
+      return v;
+    }
+
+    /// read length-prefixed string (points into mapped file)
+    [[nodiscard]] const char* read_string()
+    {
+      auto len = read<uint32_t>();
+      auto str = reinterpret_cast<const char*>(read(size_t(len) + 1));
+      if (TORI_UNLIKELY(str[len] != '\0'))
+        throw serialize_error("broken string");
+      return str;
+    }
+
+    /// skip padding to 8 byte boundary
+    void align() noexcept
+    {
+      m_pos = std::min((m_pos + 7) & ~size_t(7), m_size);
+    }
+
+  private:
+    const std::byte* m_data;
+    size_t m_size;
+    size_t m_pos;
+  };
+
+  // ------------------------------------------
+  // codecs
+
+  /// serialize payload of box
+  using box_write_func = void (*)(const Object*, archive_buffer&);
+  /// deserialize payload of box
+  using box_read_func = object_ptr<const Object> (*)(archive_reader&);
+  /// create fresh closure
+  using closure_create_func = object_ptr<const Object> (*)();
+
+  /// trivially copyable values are stored inline
+  template <class T>
+  void box_write_inline(const Object* obj, archive_buffer& buff)
+  {
+    buff.write(static_cast<const T*>(obj)->value);
+  }
+
+  template <class T>
+  object_ptr<const Object> box_read_inline(archive_reader& reader)
+  {
+    constexpr auto size = sizeof(typename T::value_type);
+    auto obj = make_object<T>();
+    std::memcpy(obj.value(), reader.read(size), size);
+    return obj;
+  }
+
+  inline void box_write_string(const Object* obj, archive_buffer& buff)
+  {
+    buff.write_string(static_cast<const String*>(obj)->value.c_str());
+  }
+
+  inline object_ptr<const Object> box_read_string(archive_reader& reader)
+  {
+    return make_object<String>(reader.read_string());
+  }
+
+  template <class T>
+  object_ptr<const Object> closure_create()
+  {
+    return make_object<T>();
+  }
+
+  /// codec entry
+  struct archive_codec
+  {
+    /// name of type
+    std::string name;
+    /// type object (value types only)
+    object_ptr<const Type> type;
+    /// box codec
+    box_write_func write;
+    box_read_func read;
+    /// closure codec
+    closure_create_func create;
+  };
+
+  namespace interface {
+
+    /// Set of serializable types.
+    /// Boxes are identified by name of their value type, closures by name
+    /// given on registration.
+    class archive_registry
+    {
+    public:
+      /// Ctor
+      archive_registry()
+      {
+        register_box<String>(box_write_string, box_read_string);
+      }
+
+      /// register box type with custom codec
+      template <class T>
+      void register_box(box_write_func write, box_read_func read)
+      {
+        auto type = object_type<T>();
+        if (TORI_UNLIKELY(!is_value_type(type)))
+          throw serialize_error("register_box: not a value type");
+        add(
+          &T::info_table_initializer::info_table,
+          {get<value_type>(*type).c_str(), type, write, read, nullptr});
+      }
+
+      /// register box type which has trivially copyable value
+      template <class T>
+      void register_box()
+      {
+        static_assert(
+          std::is_trivially_copyable_v<typename T::value_type>,
+          "Value type is not trivially copyable. Use custom codec.");
+        register_box<T>(box_write_inline<T>, box_read_inline<T>);
+      }
+
+      /// register closure type
+      template <class T>
+      void register_closure(const char* name)
+      {
+        auto tmp = make_object<T>();
+        add(
+          _get_storage(tmp).info_table(),
+          {name, nullptr, nullptr, nullptr, closure_create<T>});
+      }
+
+      /// find codec by info table
+      [[nodiscard]] const archive_codec*
+        find(const object_info_table* info) const
+      {
+        auto it = m_info_map.find(info);
+        if (it == m_info_map.end())
+          return nullptr;
+        return &m_codecs[it->second];
+      }
+
+      /// find codec by name
+      [[nodiscard]] const archive_codec* find(const std::string& name) const
+      {
+        auto it = m_name_map.find(name);
+        if (it == m_name_map.end())
+          return nullptr;
+        return &m_codecs[it->second];
+      }
+
+    private:
+      void add(const object_info_table* info, archive_codec codec)
+      {
+        if (TORI_UNLIKELY(m_name_map.count(codec.name)))
+          throw serialize_error("duplicated name: " + codec.name);
+        m_info_map.emplace(info, m_codecs.size());
+        m_name_map.emplace(codec.name, m_codecs.size());
+        m_codecs.push_back(std::move(codec));
+      }
+
+    private:
+      std::deque<archive_codec> m_codecs;
+      std::unordered_map<const object_info_table*, size_t> m_info_map;
+      std::unordered_map<std::string, size_t> m_name_map;
+    };
+
+  } // namespace interface
+
+  // ------------------------------------------
+  // value type name interning
+
+  /// Keeps name buffers of value types which are not known to this process.
+  /// Interned names share ID space with static value types.
+  [[nodiscard]] inline value_type intern_value_type(const char* name)
+  {
+    struct alignas(32) aligned_name
+    {
+      value_type::buffer_type buff;
+    };
+
+    static std::mutex mtx;
+    static std::deque<aligned_name> names;
+    static std::unordered_map<uint64_t, const aligned_name*> ids;
+
+    if (TORI_UNLIKELY(std::strlen(name) >= value_type::buffer_size))
+      throw serialize_error("value type name is too long");
+
+    auto id = value_type_id(name);
+
+    std::lock_guard lock {mtx};
+    if (auto it = ids.find(id); it != ids.end()) {
+      if (TORI_UNLIKELY(std::strcmp(it->second->buff.data(), name) != 0))
+        throw serialize_error("value type ID collision: " + std::string(name));
+      return value_type {&it->second->buff, id};
+    }
+    auto& n = names.emplace_back();
+    std::strcpy(n.buff.data(), name);
+    ids.emplace(id, &n);
+    return value_type {&n.buff, id};
+  }
+
+  // ------------------------------------------
+  // serialize
+
+  class graph_serializer
+  {
+  public:
+    graph_serializer(const archive_registry& registry)
+      : m_registry {registry}
+    {
+      archive_header header {};
+      m_buff.write(header);
+    }
+
+    /// serialize a node (post order) and get its index
+    uint64_t node(const object_ptr<const Object>& obj)
+    {
+      if (!obj)
+        return archive_null_node;
+
+      // explicit stack; long chains of nodes should not overflow call stack.
+      struct frame
+      {
+        object_ptr<const Object> obj;
+        bool expanded;
+      };
+
+      std::vector<frame> stack;
+      std::vector<object_ptr<const Object>> children;
+      std::unordered_set<const Object*> visiting;
+
+      stack.push_back({obj, false});
+
+      while (!stack.empty()) {
+        auto& top = stack.back();
+
+        if (TORI_UNLIKELY(has_exception_tag(top.obj)))
+          throw serialize_error("can't serialize exception result");
+
+        // already written
+        if (m_index.count(top.obj.get())) {
+          stack.pop_back();
+          continue;
+        }
+
+        // write after children
+        if (top.expanded) {
+          auto n = std::move(top.obj);
+          stack.pop_back();
+          m_index.emplace(n.get(), write_node(n));
+          visiting.erase(n.get());
+          continue;
+        }
+
+        if (TORI_UNLIKELY(!visiting.insert(top.obj.get()).second))
+          throw serialize_error("can't serialize cyclic graph");
+
+        top.expanded = true;
+
+        children.clear();
+        get_children(top.obj, children);
+
+        // first child is written first
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+          if (*it && !m_index.count(it->get()))
+            stack.push_back({std::move(*it), false});
+      }
+
+      return m_index.at(obj.get());
+    }
+
+    /// finish archive
+    [[nodiscard]] std::vector<std::byte>
+      finish(const std::vector<uint64_t>& roots) &&
+    {
+      archive_header header {};
+      std::memcpy(header.magic, archive_magic, sizeof(archive_magic));
+      header.version = archive_version;
+      header.node_count = m_offsets.size();
+      header.root_count = roots.size();
+
+      header.offset_table = m_buff.size();
+      for (auto&& o : m_offsets) m_buff.write(o);
+
+      header.root_table = m_buff.size();
+      for (auto&& r : roots) m_buff.write(r);
+
+      m_buff.write_at(0, header);
+      return std::move(m_buff).bytes();
+    }
+
+  private:
+    /// get nodes which should be written before `obj`
+    void get_children(
+      const object_ptr<const Object>& obj,
+      std::vector<object_ptr<const Object>>& children) const
+    {
+      if (auto apply = value_cast_if<Apply>(obj)) {
+        auto& storage = _get_storage(*apply);
+        if (storage.evaluated()) {
+          children.push_back(storage.get_cache());
+        } else {
+          children.push_back(storage.app());
+          children.push_back(storage.arg());
+        }
+        return;
+      }
+
+      if (auto type = value_cast_if<Type>(obj)) {
+        if (auto arrow = get_if<arrow_type>(type.value())) {
+          children.push_back(arrow->captured);
+          children.push_back(arrow->returns);
+        }
+        return;
+      }
+
+      auto codec = m_registry.find(_get_storage(obj).info_table());
+      if (codec && codec->create) {
+        auto c = static_cast<const Closure<>*>(obj.get());
+        for (auto i = c->arity(); i < c->n_args(); ++i)
+          children.push_back(c->arg(i));
+      }
+    }
+
+    /// get index of written node
+    uint64_t index(const object_ptr<const Object>& obj) const
+    {
+      if (!obj)
+        return archive_null_node;
+      return m_index.at(obj.get());
+    }
+
+    /// write node.
+    /// \requires children of node are already written.
+    uint64_t write_node(const object_ptr<const Object>& obj)
+    {
+      // Apply
+      if (auto apply = value_cast_if<Apply>(obj)) {
+        auto& storage = _get_storage(*apply);
+        // store evaluated result instead of thunk
+        if (storage.evaluated())
+          return index(storage.get_cache());
+        auto app = index(storage.app());
+        auto arg = index(storage.arg());
+        return record(archive_record_kind::apply, [&] {
+          m_buff.write(app);
+          m_buff.write(arg);
+        });
+      }
+
+      // Type
+      if (auto type = value_cast_if<Type>(obj)) {
+        if (auto value = get_if<value_type>(type.value())) {
+          return record(archive_record_kind::type_value, [&] {
+            m_buff.write_string(value->c_str());
+          });
+        }
+        if (auto arrow = get_if<arrow_type>(type.value())) {
+          auto captured = index(arrow->captured);
+          auto returns = index(arrow->returns);
+          return record(archive_record_kind::type_arrow, [&] {
+            m_buff.write(captured);
+            m_buff.write(returns);
+          });
+        }
+        if (auto var = get_if<var_type>(type.value())) {
+          return record(
+            archive_record_kind::type_var, [&] { m_buff.write(var->id); });
+        }
+        TORI_UNREACHABLE();
+      }
+
+      auto codec = m_registry.find(_get_storage(obj).info_table());
+
+      if (TORI_UNLIKELY(!codec))
+        throw serialize_error(
+          "type is not registered: " +
+          std::string(
+            has_value_type(obj) ? get<value_type>(*get_type(obj)).c_str()
+                                : "(closure)"));
+
+      // closure
+      if (codec->create) {
+        auto c = static_cast<const Closure<>*>(obj.get());
+        auto n_args = c->n_args();
+        auto arity = c->arity();
+        std::vector<uint64_t> args;
+        for (auto i = arity; i < n_args; ++i) args.push_back(index(c->arg(i)));
+        return record(archive_record_kind::closure, [&] {
+          m_buff.write_string(codec->name.c_str());
+          m_buff.align();
+          m_buff.write(n_args);
+          m_buff.write(arity);
+          for (auto&& a : args) m_buff.write(a);
+        });
+      }
+
+      // box
+      return record(archive_record_kind::box, [&] {
+        m_buff.write_string(codec->name.c_str());
+        m_buff.align();
+        codec->write(obj.get(), m_buff);
+      });
+    }
+
+    /// write record and register offset
+    template <class F>
+    uint64_t record(archive_record_kind kind, F&& payload)
+    {
+      auto offset = m_buff.size();
+      m_buff.write(archive_record_header {kind, 0});
+      payload();
+      auto size = m_buff.size() - offset - sizeof(archive_record_header);
+      m_buff.write_at(
+        offset, archive_record_header {kind, static_cast<uint32_t>(size)});
+      m_buff.align();
+      m_offsets.push_back(offset);
+      return m_offsets.size() - 1;
+    }
+
+  private:
+    const archive_registry& m_registry;
+    archive_buffer m_buff;
+    std::vector<uint64_t> m_offsets;
+    std::unordered_map<const Object*, uint64_t> m_index;
+  };
+
+  namespace interface {
+
+    /// Serialize object graphs into byte sequence.
+    /// Shared nodes are written once and evaluated Apply nodes are replaced
+    /// with their results.
+    /// \throws serialize_error when graph contains unregistered types.
+    [[nodiscard]] inline std::vector<std::byte> serialize_graph(
+      const std::vector<object_ptr<const Object>>& roots,
+      const archive_registry& registry)
+    {
+      graph_serializer s {registry};
+      std::vector<uint64_t> idx;
+      for (auto&& r : roots) idx.push_back(s.node(r));
+      return std::move(s).finish(idx);
+    }
+
+    /// Serialize object graphs into file.
+    inline void save_graph(
+      const std::string& path,
+      const std::vector<object_ptr<const Object>>& roots,
+      const archive_registry& registry)
+    {
+      auto bytes = serialize_graph(roots, registry);
+      std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+      if (TORI_UNLIKELY(!ofs))
+        throw serialize_error("failed to open file: " + path);
+      ofs.write(
+        reinterpret_cast<const char*>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size()));
+      if (TORI_UNLIKELY(!ofs))
+        throw serialize_error("failed to write file: " + path);
+    }
+
+  } // namespace interface
+
+  // ------------------------------------------
+  // mapped_file
+
+  /// Read-only file mapping.
+  /// Falls back to reading whole file when mmap is not available.
+  class mapped_file
+  {
+  public:
+    explicit mapped_file(const std::string& path)
+    {
+#if defined(TORI_HAS_MMAP)
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (TORI_UNLIKELY(fd < 0))
+        throw serialize_error("failed to open file: " + path);
+      struct stat st;
+      if (TORI_UNLIKELY(::fstat(fd, &st) != 0)) {
+        ::close(fd);
+        throw serialize_error("failed to stat file: " + path);
+      }
+      m_size = static_cast<size_t>(st.st_size);
+      if (m_size != 0) {
+        auto p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (TORI_UNLIKELY(p == MAP_FAILED)) {
+          ::close(fd);
+          throw serialize_error("failed to map file: " + path);
+        }
+        m_data = static_cast<const std::byte*>(p);
+      }
+      ::close(fd);
+#else
+      std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+      if (TORI_UNLIKELY(!ifs))
+        throw serialize_error("failed to open file: " + path);
+      m_buffer.resize(static_cast<size_t>(ifs.tellg()));
+      ifs.seekg(0);
+      ifs.read(
+        reinterpret_cast<char*>(m_buffer.data()),
+        static_cast<std::streamsize>(m_buffer.size()));
+      m_data = m_buffer.data();
+      m_size = m_buffer.size();
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() noexcept
+    {
+#if defined(TORI_HAS_MMAP)
+      if (m_data)
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+    }
+
+    [[nodiscard]] const std::byte* data() const noexcept
+    {
+      return m_data;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+  private:
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+#if !defined(TORI_HAS_MMAP)
+    std::vector<std::byte> m_buffer;
+#endif
+  };
+
+  // ------------------------------------------
+  // graph_archive
+
+  namespace interface {
+
+    /// Loaded object graph archive.
+    /// Nodes are materialized on first access and cached, so sharing in the
+    /// original graph is preserved and unused subgraphs are never built.
+    class graph_archive
+    {
+    public:
+      /// Map file
+      graph_archive(const std::string& path, const archive_registry& registry)
+        : m_file {std::make_unique<mapped_file>(path)}
+        , m_registry {registry}
+      {
+        init(m_file->data(), m_file->size());
+      }
+
+      /// Use memory (should outlive archive)
+      graph_archive(
+        const std::byte* data,
+        size_t size,
+        const archive_registry& registry)
+        : m_registry {registry}
+      {
+        init(data, size);
+      }
+
+      /// number of roots
+      [[nodiscard]] size_t root_count() const noexcept
+      {
+        return m_roots.size();
+      }
+
+      /// number of unique nodes in archive
+      [[nodiscard]] size_t node_count() const noexcept
+      {
+        return m_nodes.size();
+      }
+
+      /// number of nodes materialized so far
+      [[nodiscard]] size_t materialized_count() const noexcept
+      {
+        return m_materialized;
+      }
+
+      /// get root (materialized on first access)
+      [[nodiscard]] object_ptr<const Object> root(size_t n)
+      {
+        if (TORI_UNLIKELY(n >= m_roots.size()))
+          throw serialize_error("root index out of range");
+        return node(m_roots[n]);
+      }
+
+      /// get node (materialized on first access)
+      [[nodiscard]] object_ptr<const Object> node(uint64_t idx)
+      {
+        if (idx == archive_null_node)
+          return nullptr;
+        if (TORI_UNLIKELY(idx >= m_nodes.size()))
+          throw serialize_error("node index out of range");
+        if (!m_nodes[idx])
+          materialize(idx);
+        return m_nodes[idx];
+      }
+
+    private:
+      void init(const std::byte* data, size_t size)
+      {
+        m_data = data;
+        m_size = size;
+
+        if (TORI_UNLIKELY(size < sizeof(archive_header)))
+          throw serialize_error("file is too small");
+
+        std::memcpy(&m_header, data, sizeof(archive_header));
+
+        if (TORI_UNLIKELY(
+              std::memcmp(m_header.magic, archive_magic, 8) != 0 ||
+              m_header.version != archive_version))
+          throw serialize_error("invalid file header");
+
+        // table fits in file? (without overflow)
+        auto fits = [&](uint64_t offset, uint64_t count) {
+          return offset <= size &&
+                 count <= (size - offset) / sizeof(uint64_t);
+        };
+
+        if (TORI_UNLIKELY(
+              !fits(m_header.offset_table, m_header.node_count) ||
+              !fits(m_header.root_table, m_header.root_count)))
+          throw serialize_error("broken file");
+
+        m_nodes.resize(m_header.node_count);
+        m_roots.resize(m_header.root_count);
+        std::memcpy(
+          m_roots.data(),
+          data + m_header.root_table,
+          m_roots.size() * sizeof(uint64_t));
+      }
+
+      [[nodiscard]] uint64_t offset(uint64_t idx) const
+      {
+        uint64_t o;
+        std::memcpy(
+          &o,
+          m_data + m_header.offset_table + idx * sizeof(uint64_t),
+          sizeof(o));
+        return o;
+      }
+
+      /// get record of node
+      [[nodiscard]] std::pair<archive_record_kind, archive_reader>
+        record(uint64_t idx) const
+      {
+        auto o = offset(idx);
+        if (TORI_UNLIKELY(
+              o > m_size || sizeof(archive_record_header) > m_size - o))
+          throw serialize_error("broken offset table");
+
+        archive_record_header rh;
+        std::memcpy(&rh, m_data + o, sizeof(rh));
+
+        auto head = o + sizeof(archive_record_header);
+        if (TORI_UNLIKELY(rh.size > m_size - head))
+          throw serialize_error("broken record");
+
+        return {rh.kind, archive_reader(m_data + head, rh.size)};
+      }
+
+      /// read index of child node.
+      /// records are written in post order, so children have smaller index.
+      [[nodiscard]] static uint64_t
+        read_child(archive_reader& reader, uint64_t idx)
+      {
+        auto child = reader.read<uint64_t>();
+        if (TORI_UNLIKELY(child != archive_null_node && child >= idx))
+          throw serialize_error("broken node reference");
+        return child;
+      }
+
+      /// get indices of children of node
+      void get_children(uint64_t idx, std::vector<uint64_t>& children)
+      {
+        auto [kind, reader] = record(idx);
+        switch (kind) {
+          case archive_record_kind::apply:
+          case archive_record_kind::type_arrow:
+            children.push_back(read_child(reader, idx));
+            children.push_back(read_child(reader, idx));
+            break;
+          case archive_record_kind::closure:
+          {
+            (void)reader.read_string();
+            reader.align();
+            auto n_args = reader.read<uint64_t>();
+            auto arity = reader.read<uint64_t>();
+            for (auto i = arity; i < n_args; ++i)
+              children.push_back(read_child(reader, idx));
+            break;
+          }
+          default:
+            break;
+        }
+      }
+
+      /// materialize node and its children.
+      /// explicit stack; long chains of nodes should not overflow call stack.
+      void materialize(uint64_t idx)
+      {
+        std::vector<uint64_t> stack {idx};
+        std::vector<uint64_t> children;
+
+        while (!stack.empty()) {
+          auto top = stack.back();
+
+          if (m_nodes[top]) {
+            stack.pop_back();
+            continue;
+          }
+
+          children.clear();
+          get_children(top, children);
+
+          auto ready = true;
+          for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (*it != archive_null_node && !m_nodes[*it]) {
+              stack.push_back(*it);
+              ready = false;
+            }
+          }
+
+          if (ready) {
+            m_nodes[top] = load(top);
+            if (TORI_UNLIKELY(!m_nodes[top]))
+              throw serialize_error("broken record");
+            ++m_materialized;
+            stack.pop_back();
+          }
+        }
+      }
+
+      /// get materialized child
+      [[nodiscard]] const object_ptr<const Object>&
+        child(archive_reader& reader, uint64_t idx) const
+      {
+        static const object_ptr<const Object> null = nullptr;
+        auto c = read_child(reader, idx);
+        if (c == archive_null_node)
+          return null;
+        TORI_ASSERT(m_nodes[c]);
+        return m_nodes[c];
+      }
+
+      /// create object of node.
+      /// \requires children of node are materialized.
+      [[nodiscard]] object_ptr<const Object> load(uint64_t idx)
+      {
+        auto [kind, reader] = record(idx);
+
+        switch (kind) {
+          case archive_record_kind::apply:
+          {
+            auto& app = child(reader, idx);
+            auto& arg = child(reader, idx);
+            return make_object<Apply>(app, arg);
+          }
+          case archive_record_kind::type_value:
+          {
+            auto name = reader.read_string();
+            // reuse static type objects when possible
+            if (auto codec = m_registry.find(name); codec && codec->type)
+              return codec->type;
+            return make_object<Type>(intern_value_type(name));
+          }
+          case archive_record_kind::type_arrow:
+          {
+            auto& captured = child(reader, idx);
+            auto& returns = child(reader, idx);
+            return make_object<Type>(arrow_type {
+              static_object_cast<const Type>(captured),
+              static_object_cast<const Type>(returns)});
+          }
+          case archive_record_kind::type_var:
+          {
+            // type variables get fresh id in this process
+            auto id = reader.read<uint64_t>();
+            auto& var = m_vars[id];
+            if (!var)
+              var = genvar();
+            return var;
+          }
+          case archive_record_kind::box:
+          {
+            auto codec = find_codec(reader);
+            if (TORI_UNLIKELY(!codec->read))
+              throw serialize_error("not a box type: " + codec->name);
+            return codec->read(reader);
+          }
+          case archive_record_kind::closure:
+          {
+            auto codec = find_codec(reader);
+            if (TORI_UNLIKELY(!codec->create))
+              throw serialize_error("not a closure type: " + codec->name);
+            auto n_args = reader.read<uint64_t>();
+            auto arity = reader.read<uint64_t>();
+            auto obj = codec->create();
+            auto c = static_cast<const Closure<>*>(obj.get());
+            if (TORI_UNLIKELY(c->n_args() != n_args || arity > n_args))
+              throw serialize_error("closure signature changed");
+            c->arity() = arity;
+            for (auto i = arity; i < n_args; ++i)
+              write_closure_arg(c->arg(i), child(reader, idx));
+            return obj;
+          }
+        }
+        throw serialize_error("unknown record kind");
+      }
+
+      /// read name and find codec
+      [[nodiscard]] const archive_codec* find_codec(archive_reader& reader)
+      {
+        auto name = reader.read_string();
+        auto codec = m_registry.find(name);
+        if (TORI_UNLIKELY(!codec))
+          throw serialize_error("type is not registered: " + std::string(name));
+        reader.align();
+        return codec;
+      }
+
+    private:
+      /// mapped file
+      std::unique_ptr<mapped_file> m_file;
+      /// registry
+      const archive_registry& m_registry;
+      /// raw data
+      const std::byte* m_data = nullptr;
+      size_t m_size = 0;
+      /// header
+      archive_header m_header = {};
+      /// root indicies
+      std::vector<uint64_t> m_roots;
+      /// materialized nodes
+      std::vector<object_ptr<const Object>> m_nodes;
+      /// number of materialized nodes
+      size_t m_materialized = 0;
+      /// var id map
+      std::unordered_map<uint64_t, object_ptr<const Type>> m_vars;
+    };
+
+    /// Load single graph from file
+    [[nodiscard]] inline object_ptr<const Object>
+      load_graph(const std::string& path, const archive_registry& registry)
+    {
+      graph_archive ar {path, registry};
+      if (TORI_UNLIKELY(ar.root_count() != 1))
+        throw serialize_error("archive has multiple roots");
+      return ar.root(0);
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
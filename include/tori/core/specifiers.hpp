@@ -26,6 +26,11 @@ namespace TORI_NS::detail {
     template <class T>
     struct object;
 
+    /// strict specifier
+    /// Argument of Function is evaluated before code() is called.
+    template <class T>
+    struct strict;
+
   } // namespace interface
 
   // ------------------------------------------
@@ -104,9 +109,38 @@ namespace TORI_NS::detail {
     return true_c;
   }
 
+  // ------------------------------------------
+  // is_strict_specifier
+
+  template <class T>
+  constexpr auto is_strict_specifier(meta_type<T>)
+  {
+    return false_c;
+  }
+
+  template <class T>
+  constexpr auto is_strict_specifier(meta_type<strict<T>>)
+  {
+    return true_c;
+  }
+
+  /// bit mask of strict specifiers in Ts
+  template <class... Ts>
+  constexpr uint64_t get_strict_mask()
+  {
+    uint64_t mask = 0;
+    uint64_t bit = 1;
+    ((mask |= is_strict_specifier(type_c<Ts>) ? bit : 0, bit <<= 1), ...);
+    return mask;
+  }
+
   // ------------------------------------------
   // normalize_specifier
 
+  /// strictness does not affect type
+  template <class T>
+  constexpr auto normalize_specifier(meta_type<strict<T>>);
+
   /// lift all raw types to specifiers
   template <class T>
   constexpr auto normalize_specifier(meta_type<T> t)
@@ -128,6 +162,12 @@ namespace TORI_NS::detail {
       closure<typename decltype(normalize_specifier(type_c<Ts>))::type...>>;
   }
 
+  template <class T>
+  constexpr auto normalize_specifier(meta_type<strict<T>>)
+  {
+    return normalize_specifier(type_c<T>);
+  }
+
   // ------------------------------------------
   // get_proxy_type
 
@@ -0,0 +1,230 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Evaluation of statically typed apply graphs
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "eval.hpp"
+#endif
+
+#include <type_traits>
+
+namespace TORI_NS::detail {
+
+  // ------------------------------------------
+  // static_apply_chain
+
+  /// Apply object? (compares info table instead of type)
+  [[nodiscard]] inline bool is_apply_object(object_ref<const Object> obj)
+  {
+    constexpr auto info = &Apply::info_table_initializer::info_table;
+    return !has_exception_tag(obj) && get_info_table(obj.get()) == info;
+  }
+
+  /// is_whnf() for static_eval
+  [[nodiscard]] inline bool is_static_whnf(object_ref<const Object> obj)
+  {
+    return !has_exception_tag(obj) && !is_apply_object(obj);
+  }
+
+  /// closure type and arity of Function
+  template <class T, class... Ts>
+  struct function_traits
+  {
+    /// CRTP closure type
+    using closure_type = T;
+    /// arity
+    static constexpr size_t arity = sizeof...(Ts) - 1;
+  };
+
+  // (not defined)
+  template <class T, class... Ts>
+  function_traits<T, Ts...> get_function_traits(const Function<T, Ts...>*);
+
+  /// Chain of TApply nodes which applies arguments to a Function.
+  /// Not valid for other types.
+  template <class T, class = void>
+  struct static_apply_chain
+  {
+    static constexpr bool valid = false;
+    static constexpr size_t arity = 0;
+    static constexpr size_t n_args = 0;
+    using closure_type = void;
+  };
+
+  /// Function
+  template <class F>
+  struct static_apply_chain<
+    F,
+    std::void_t<decltype(get_function_traits(std::declval<const F*>()))>>
+  {
+    using traits = decltype(get_function_traits(std::declval<const F*>()));
+
+    static constexpr bool valid = true;
+    static constexpr size_t arity = traits::arity;
+    static constexpr size_t n_args = 0;
+    using closure_type = typename traits::closure_type;
+
+    /// fresh closure of closure_type?
+    [[nodiscard]] static const closure_type* closure(const Object* obj)
+    {
+      if (has_exception_tag(object_ref(obj)))
+        return nullptr;
+      // reject derived types and partially applied closures
+      if (get_info_table(obj) != get_closure_info_table<closure_type>())
+        return nullptr;
+      auto c = static_cast<const closure_type*>(obj);
+      if (static_cast<const Closure<>*>(c)->arity() != arity)
+        return nullptr;
+      return c;
+    }
+
+    static void push_args(const Object*, const Closure<>*) noexcept
+    {
+    }
+
+    static void force_strict_args(const Object*, const Closure<>*)
+    {
+    }
+  };
+
+  template <class T>
+  [[nodiscard]] object_ptr<const Object>
+    static_eval_impl(object_ref<const Object> obj);
+
+  /// TApply
+  template <class App, class Arg>
+  struct static_apply_chain<TApply<App, Arg>>
+  {
+    using app_chain = static_apply_chain<std::remove_const_t<App>>;
+
+    static constexpr bool valid =
+      app_chain::valid && app_chain::n_args < app_chain::arity;
+    static constexpr size_t arity = app_chain::arity;
+    static constexpr size_t n_args = app_chain::n_args + 1;
+    using closure_type = typename app_chain::closure_type;
+
+    /// index of Arg in parameters
+    static constexpr size_t index = n_args - 1;
+
+    /// get storage of node
+    [[nodiscard]] static auto& storage(const Object* obj)
+    {
+      return _get_storage(static_cast<const Apply*>(obj)->value);
+    }
+
+    /// get closure at head of unevaluated chain.
+    /// \returns nullptr when runtime graph does not match.
+    [[nodiscard]] static const closure_type* closure(const Object* obj)
+    {
+      if (!is_apply_object(obj))
+        return nullptr;
+      auto& s = storage(obj);
+      if (s.evaluated())
+        return nullptr;
+      return app_chain::closure(s.app().get());
+    }
+
+    /// push arguments to closure without evaluation
+    static void push_args(const Object* obj, const Closure<>* c) noexcept
+    {
+      auto& s = storage(obj);
+      app_chain::push_args(s.app().get(), c);
+      auto arity = --c->arity();
+      write_closure_arg(c->arg(arity), s.arg());
+    }
+
+    /// evaluate strict arguments pushed by push_args()
+    static void force_strict_args(const Object* obj, const Closure<>* c)
+    {
+      app_chain::force_strict_args(storage(obj).app().get(), c);
+      if constexpr ((closure_type::strict_args >> index) & 1) {
+        auto& a = c->arg(arity - 1 - index);
+        if (!is_static_whnf(a))
+          write_closure_arg(a, static_eval_impl<std::remove_const_t<Arg>>(a));
+      }
+    }
+  };
+
+  /// static_eval implementation.
+  /// Falls back to eval_impl() when `T` is not a saturated application of a
+  /// Function or runtime graph does not match its static type.
+  template <class T>
+  [[nodiscard]] object_ptr<const Object>
+    static_eval_impl(object_ref<const Object> obj)
+  {
+    using chain = static_apply_chain<T>;
+
+    if constexpr (chain::valid && chain::n_args == chain::arity) {
+
+      using closure_type = typename chain::closure_type;
+
+      if (!is_apply_object(obj))
+        return eval_impl(obj);
+
+      auto& apply_storage = chain::storage(obj.get());
+
+      // graph reduction
+      if (apply_storage.evaluated()) {
+        profile_cache_hit();
+        return apply_storage.get_cache();
+      }
+
+      // evictable caches are handled by eval_impl()
+      if (get_apply_cache_budget())
+        return eval_impl(obj);
+
+      auto f = chain::closure(obj.get());
+
+      if (!f)
+        return eval_impl(obj);
+
+      trace_scope trace {trace_kind::eval, nullptr};
+
+      profile_cache_miss(get_info_table(f));
+
+      // saturate copy of closure on stack
+      closure_type pap {*f};
+      auto cpap = static_cast<const Closure<>*>(&pap);
+
+      chain::push_args(obj.get(), cpap);
+
+      // call code() directly
+      auto ret = call_code_func<closure_type>(
+        cpap, [&] { chain::force_strict_args(obj.get(), cpap); });
+
+      if (!is_static_whnf(ret))
+        ret = eval_impl(ret);
+
+      // set cache
+      apply_storage.set_cache(ret);
+
+      return ret;
+
+    } else
+      return eval_impl(obj);
+  }
+
+  namespace interface {
+
+    /// Evaluate graph using static types of TApply nodes.
+    ///
+    /// Saturated applications of Function closures in `obj` are evaluated
+    /// by calling code() directly, without info table lookup and cloning of
+    /// partially applied closures. Strict arguments are evaluated in the
+    /// same way, lazy arguments are passed as they are.
+    /// Result is equal to eval().
+    /// \notes code() should not keep reference to its closure object.
+    template <class T>
+    [[nodiscard]] auto static_eval(const object_ptr<T>& obj)
+    {
+      return eval_result_cast<T>(
+        static_eval_impl<std::remove_const_t<T>>(object_ref(obj)));
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
@@ -47,14 +47,25 @@ namespace TORI_NS::detail {
   // ------------------------------------------
   // subst_all
 
+  /// fold helper for subst_all
+  template <class T>
+  struct subst_folder
+  {
+    using type = T;
+
+    template <class TyArrow>
+    constexpr auto operator|(meta_type<TyArrow> a) const
+    {
+      return subst_folder<meta_type_t<decltype(subst(a, type_c<T>))>> {};
+    }
+  };
+
   /// Process list of type substitution
   template <class... TyArrow, class Ty>
-  constexpr auto subst_all(meta_tuple<TyArrow...> tyarrows, meta_type<Ty> type)
+  constexpr auto subst_all(meta_tuple<TyArrow...>, meta_type<Ty>)
   {
-    if constexpr (empty(tyarrows))
-      return type;
-    else
-      return subst_all(tail(tyarrows), subst(head(tyarrows), type));
+    using result = decltype((subst_folder<Ty> {} | ... | type_c<TyArrow>));
+    return type_c<typename result::type>;
   }
 
   // ------------------------------------------
@@ -117,23 +128,6 @@ namespace TORI_NS::detail {
   // ------------------------------------------
   // compose_subst
 
-  template <class... TyArrows, class TyT1, class TyT2, class... Results>
-  constexpr auto compose_subst_impl(
-    meta_tuple<TyArrows...> tyarrows,
-    meta_type<tyarrow<TyT1, TyT2>> a,
-    meta_tuple<Results...> result)
-  {
-    auto h = head(tyarrows);
-    auto t = tail(tyarrows);
-
-    auto r = make_tyarrow(h.t1(), subst(a, h.t2()));
-
-    if constexpr (empty(t))
-      return append(r, result);
-    else
-      return compose_subst_impl(t, a, append(r, result));
-  }
-
   /// compose substitution
   template <class... TyArrows, class TyT1, class TyT2>
   constexpr auto compose_subst(
@@ -143,13 +137,12 @@ namespace TORI_NS::detail {
     // g(f(S)):
     // | X->g(T) when (X->T) belongs f
     // | X->T    when (X->T) belongs g && X not belongs dom(f)
-    if constexpr (empty(tyarrows))
-      return make_tuple(a);
-    else {
-      auto r = compose_subst_impl(tyarrows, a, tuple_c<>);
-      // FIXME: add domain check
-      return append(a, r);
-    }
+    (void)tyarrows;
+    // FIXME: add domain check
+    return tuple_c<
+      meta_type_t<decltype(make_tyarrow(
+        type_c<TyArrows>.t1(), subst(a, type_c<TyArrows>.t2())))>...,
+      tyarrow<TyT1, TyT2>>;
   }
 
   // ------------------------------------------
@@ -338,52 +331,100 @@ namespace TORI_NS::detail {
   // ------------------------------------------
   // genpoly
 
-  /// Recursively traverse term tree and replace tm_var with new one.
-  /// \param term a point on term tree currently being processed
-  /// \param gen generator
-  /// \param target current result of procedure
-  template <class Term, class Gen, class Target>
-  constexpr auto genpoly_impl(
+  /// Collect tm_var in term tree in traversal order (with duplicates).
+  template <class Term>
+  constexpr auto genpoly_vars(meta_type<Term> term);
+
+  template <class... Ts>
+  constexpr auto genpoly_vars_closure(meta_type<tm_closure<Ts...>>)
+  {
+    return (set_builder<> {} + ... + genpoly_vars(type_c<Ts>));
+  }
+
+  template <class Term>
+  constexpr auto genpoly_vars(meta_type<Term> term)
+  {
+    if constexpr (is_tm_closure(term))
+      return genpoly_vars_closure(term);
+    else if constexpr (is_tm_apply(term))
+      return genpoly_vars(term.t1()) + genpoly_vars(term.t2());
+    else if constexpr (is_tm_var(term))
+      return set_builder<Term> {};
+    else
+      return set_builder<> {};
+  }
+
+  template <class... Ts, size_t N, class... Vars>
+  constexpr auto genpoly_subst_closure(
+    meta_type<tm_closure<Ts...>>,
+    meta_type<taggen<N>> gen,
+    meta_tuple<Vars...> vars);
+
+  /// Replace each tm_var with `tm_var<taggen<N + I>>` where I is index of
+  /// first occurrence of the var in `Vars`.
+  template <class Term, size_t N, class... Vars>
+  constexpr auto genpoly_subst(
     meta_type<Term> term,
-    meta_type<Gen> gen,
-    meta_type<Target> target)
+    meta_type<taggen<N>> gen,
+    meta_tuple<Vars...> vars)
   {
+    (void)gen;
+    (void)vars;
+
     if constexpr (is_tm_closure(term)) {
-      if constexpr (empty(to_tuple(term))) {
-        return make_pair(target, gen);
-      } else {
-        auto h = head(term);
-        auto t = tail(term);
-        auto p1 = genpoly_impl(h, gen, target);
-        auto t1 = p1.first();
-        auto g1 = p1.second();
-        return genpoly_impl(t, g1, t1);
-      }
+      return genpoly_subst_closure(term, gen, vars);
     } else if constexpr (is_tm_apply(term)) {
-      auto p1 = genpoly_impl(term.t1(), gen, target);
-      auto t1 = p1.first();
-      auto g1 = p1.second();
-
-      auto p2 = genpoly_impl(term.t2(), g1, t1);
-      auto t2 = p2.first();
-      auto g2 = p2.second();
-      return make_pair(make_tm_apply(t1, t2), g2);
+      return make_tm_apply(
+        genpoly_subst(term.t1(), gen, vars),
+        genpoly_subst(term.t2(), gen, vars));
     } else if constexpr (is_tm_var(term)) {
-      return make_pair(subst_term(term, gen_tm_var(gen), target), nextgen(gen));
+      return gen_tm_var(gen_c<N + set_find_first<Term, Vars...>()>);
     } else
-      return make_pair(target, gen);
+      return term;
+  }
+
+  template <class... Ts, size_t N, class... Vars>
+  constexpr auto genpoly_subst_closure(
+    meta_type<tm_closure<Ts...>>,
+    meta_type<taggen<N>> gen,
+    meta_tuple<Vars...> vars)
+  {
+    return type_c<tm_closure<
+      meta_type_t<decltype(genpoly_subst(type_c<Ts>, gen, vars))>...>>;
   }
 
   /// create fresh polymorphoc closure
-  template <class Term, class Gen>
-  constexpr auto genpoly(meta_type<Term> term, meta_type<Gen> gen)
+  template <class Term, size_t N>
+  constexpr auto genpoly(meta_type<Term> term, meta_type<taggen<N>> gen)
   {
-    return genpoly_impl(term, gen, term);
+    constexpr auto vars = genpoly_vars(term);
+    return make_pair(
+      genpoly_subst(term, gen, vars.tuple()),
+      gen_c<N + vars.tuple().size()>);
   }
 
   // ------------------------------------------
   // type_of
 
+  template <class T1, class T2, class Gen, bool Assert>
+  constexpr auto type_of_impl(
+    meta_type<tm_apply<T1, T2>>,
+    meta_type<Gen> gen,
+    std::bool_constant<Assert> enable_assert);
+
+  /// Does argument type exactly match to parameter type of closure?
+  template <class T1, class T2>
+  constexpr auto is_exact_apply(meta_type<T1>, meta_type<T2>)
+  {
+    return false_c;
+  }
+
+  template <class A, class R>
+  constexpr auto is_exact_apply(meta_type<arrow<A, R>>, meta_type<A>)
+  {
+    return true_c;
+  }
+
   /// Convert `tm_closure<T1, T2...>` to `arrow<T1, arrow<T2, ...>>`.
   /// \param term term
   /// \param gen generator
@@ -433,33 +474,7 @@ namespace TORI_NS::detail {
     (void)gen;
     (void)enable_assert;
 
-    if constexpr (is_tm_apply(term)) {
-      // app
-      auto p1 = type_of_impl(term.t1(), gen, enable_assert);
-      auto t1 = p1.first();
-      auto g1 = p1.second();
-      if constexpr (is_error_type(t1)) {
-        return make_pair(t1, g1);
-      } else {
-        // arg
-        auto p2 = type_of_impl(term.t2(), g1, enable_assert);
-        auto t2 = p2.first();
-        auto g2 = p2.second();
-        if constexpr (is_error_type(t2)) {
-          return make_pair(t2, g2);
-        } else {
-          // type check subtree
-          auto var = gen_var(g2);
-          auto g3 = nextgen(g2);
-          auto c = make_tuple(make_constr(t1, make_arrow(t2, var)));
-          auto s = unify(c, enable_assert);
-          if constexpr (is_error_type(s))
-            return make_pair(s, g3);
-          else
-            return make_pair(subst_all(s, var), g3);
-        }
-      }
-    } else if constexpr (is_tm_closure(term)) {
+    if constexpr (is_tm_closure(term)) {
       // generate fresh polymorphoc type
       auto p1 = genpoly(term, gen);
       auto t1 = p1.first();
@@ -476,6 +491,49 @@ namespace TORI_NS::detail {
       static_assert(false_v<Term>, "Invalid term");
   }
 
+  /// Infer a type of tm_apply.
+  /// Separate overload keeps large apply terms away from term predicates,
+  /// which reduces number of instantiations on deep apply trees.
+  template <class T1, class T2, class Gen, bool Assert>
+  constexpr auto type_of_impl(
+    meta_type<tm_apply<T1, T2>>,
+    meta_type<Gen> gen,
+    std::bool_constant<Assert> enable_assert)
+  {
+    (void)gen;
+    (void)enable_assert;
+
+    // app
+    auto p1 = type_of_impl(type_c<T1>, gen, enable_assert);
+    auto t1 = p1.first();
+    auto g1 = p1.second();
+    if constexpr (is_error_type(t1)) {
+      return make_pair(t1, g1);
+    } else {
+      // arg
+      auto p2 = type_of_impl(type_c<T2>, g1, enable_assert);
+      auto t2 = p2.first();
+      auto g2 = p2.second();
+      if constexpr (is_error_type(t2)) {
+        return make_pair(t2, g2);
+      } else if constexpr (is_exact_apply(t1, t2)) {
+        // fast path: unification would only map the fresh var to return
+        // type. still consume the var to keep numbering.
+        return make_pair(t1.t2(), nextgen(g2));
+      } else {
+        // type check subtree
+        auto var = gen_var(g2);
+        auto g3 = nextgen(g2);
+        auto c = make_tuple(make_constr(t1, make_arrow(t2, var)));
+        auto s = unify(c, enable_assert);
+        if constexpr (is_error_type(s))
+          return make_pair(s, g3);
+        else
+          return make_pair(subst_all(s, var), g3);
+      }
+    }
+  }
+
   /// Infer type of term tree
   /// \param term term
   /// \param enable_assert option to control `static_assert`
@@ -7,6 +7,7 @@
 
 #if !defined(TORI_NO_LOCAL_INCLUDE)
 #  include "type_gen.hpp"
+#  include "object_size.hpp"
 #endif
 
 #include <string>
@@ -69,6 +70,12 @@ namespace TORI_NS::detail {
       return reinterpret_cast<const char*>(m_ptr);
     }
 
+    /// size of buffer
+    [[nodiscard]] size_t heap_size() const noexcept
+    {
+      return std::strlen(c_str()) + 1;
+    }
+
   private:
     char* m_ptr;
   };
@@ -79,7 +86,6 @@ namespace TORI_NS::detail {
     /// Does not guarantee anything about encoding. User must ensure
     /// input byte sequence is null(`0x00`)-terminated UTF-8 string.
     using String = Box<string_object_value>;
-
     namespace literals {
 
       /// String object literal
@@ -93,6 +99,10 @@ namespace TORI_NS::detail {
 
   } // namespace interface
 
+  /// register heap_size() for object_size()
+  inline const bool string_heap_size_registered =
+    register_heap_size<String>();
+
 } // namespace TORI_NS::detail
 
 // String
@@ -0,0 +1,287 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Evaluation event tracing
+///
+/// Define `TORI_ENABLE_TRACE` to enable tracer, then call start_trace() to
+/// record events. Each thread writes begin/end events into its own ring
+/// buffer without locks. When disabled, all hooks are empty.
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#endif
+
+#include <vector>
+#include <cstdint>
+
+#if defined(TORI_ENABLE_TRACE)
+#  include <mutex>
+#  include <memory>
+#  include <atomic>
+#  include <chrono>
+#  include <algorithm>
+#endif
+
+/// number of events in per-thread ring buffer (should be power of 2)
+#if !defined(TORI_TRACE_BUFFER_SIZE)
+#  define TORI_TRACE_BUFFER_SIZE 65536
+#endif
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    /// trace event phase
+    enum class trace_phase : uint8_t
+    {
+      begin = 0,
+      end   = 1,
+    };
+
+    /// trace event kind
+    enum class trace_kind : uint8_t
+    {
+      /// forcing Apply node
+      eval = 0,
+      /// call to code()
+      code = 1,
+    };
+
+    /// trace event
+    struct trace_event
+    {
+      /// timestamp (ns)
+      uint64_t timestamp;
+      /// thread id (sequential)
+      uint32_t thread;
+      /// phase
+      trace_phase phase;
+      /// kind
+      trace_kind kind;
+      /// type of closure (null for eval events)
+      object_ptr<const Type> type;
+    };
+
+  } // namespace interface
+
+#if defined(TORI_ENABLE_TRACE)
+
+  static_assert(
+    (TORI_TRACE_BUFFER_SIZE & (TORI_TRACE_BUFFER_SIZE - 1)) == 0,
+    "TORI_TRACE_BUFFER_SIZE should be power of 2");
+
+  /// runtime switch
+  inline std::atomic<bool> trace_active = false;
+
+  /// ring buffer slot.
+  /// fields are atomic since slots can be overwritten while exporting.
+  struct trace_slot
+  {
+    std::atomic<uint64_t> timestamp;
+    std::atomic<const object_info_table*> info;
+    std::atomic<uint32_t> tag;
+  };
+
+  /// single producer ring buffer
+  struct trace_buffer
+  {
+    static constexpr uint64_t capacity = TORI_TRACE_BUFFER_SIZE;
+
+    trace_buffer(uint32_t id)
+      : thread {id}
+      , slots {std::make_unique<trace_slot[]>(capacity)}
+    {
+    }
+
+    /// push event (owner thread only)
+    void push(
+      trace_phase phase,
+      trace_kind kind,
+      const object_info_table* info) noexcept
+    {
+      auto ts = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now().time_since_epoch())
+                  .count();
+      auto h     = head.load(std::memory_order_relaxed);
+      auto& slot = slots[h & (capacity - 1)];
+      slot.timestamp.store(ts, std::memory_order_relaxed);
+      slot.info.store(info, std::memory_order_relaxed);
+      slot.tag.store(
+        static_cast<uint32_t>(phase) | static_cast<uint32_t>(kind) << 8,
+        std::memory_order_relaxed);
+      head.store(h + 1, std::memory_order_release);
+    }
+
+    /// thread id
+    const uint32_t thread;
+    /// slots
+    std::unique_ptr<trace_slot[]> slots;
+    /// number of events written
+    std::atomic<uint64_t> head = 0;
+    /// position of last clear
+    std::atomic<uint64_t> tail = 0;
+  };
+
+  /// global list of buffers
+  struct trace_registry
+  {
+    std::mutex mtx;
+    std::vector<std::shared_ptr<trace_buffer>> buffers;
+
+    static trace_registry& get()
+    {
+      static trace_registry registry;
+      return registry;
+    }
+  };
+
+  /// get buffer of current thread
+  [[nodiscard]] inline trace_buffer& trace_this_thread()
+  {
+    thread_local auto buffer = [] {
+      auto& r = trace_registry::get();
+      std::lock_guard lock {r.mtx};
+      auto b =
+        std::make_shared<trace_buffer>(static_cast<uint32_t>(r.buffers.size()));
+      r.buffers.push_back(b);
+      return b;
+    }();
+    return *buffer;
+  }
+
+  /// RAII hook for eval_impl and vtbl_code_func
+  class trace_scope
+  {
+  public:
+    trace_scope(trace_kind kind, const object_info_table* info) noexcept
+      : m_kind {kind}
+      , m_info {info}
+    {
+      if (TORI_UNLIKELY(trace_active.load(std::memory_order_relaxed))) {
+        m_buffer = &trace_this_thread();
+        m_buffer->push(trace_phase::begin, m_kind, m_info);
+      }
+    }
+
+    ~trace_scope() noexcept
+    {
+      if (TORI_UNLIKELY(m_buffer))
+        m_buffer->push(trace_phase::end, m_kind, m_info);
+    }
+
+  private:
+    trace_kind m_kind;
+    const object_info_table* m_info;
+    trace_buffer* m_buffer = nullptr;
+  };
+
+#else
+
+  /// RAII hook for eval_impl and vtbl_code_func (disabled)
+  class trace_scope
+  {
+  public:
+    trace_scope(trace_kind, const object_info_table*) noexcept
+    {
+    }
+  };
+
+#endif
+
+  namespace interface {
+
+    /// Start recording events.
+    /// \notes No effect when tracer is disabled.
+    inline void start_trace() noexcept
+    {
+#if defined(TORI_ENABLE_TRACE)
+      trace_active.store(true, std::memory_order_relaxed);
+#endif
+    }
+
+    /// Stop recording events.
+    inline void stop_trace() noexcept
+    {
+#if defined(TORI_ENABLE_TRACE)
+      trace_active.store(false, std::memory_order_relaxed);
+#endif
+    }
+
+    /// Recording events?
+    [[nodiscard]] inline bool is_tracing() noexcept
+    {
+#if defined(TORI_ENABLE_TRACE)
+      return trace_active.load(std::memory_order_relaxed);
+#else
+      return false;
+#endif
+    }
+
+    /// Collect recorded events of all threads.
+    /// Events are ordered by thread, then by time. End events whose begin
+    /// event was overwritten in ring buffer are dropped.
+    [[nodiscard]] inline std::vector<trace_event> get_trace()
+    {
+      std::vector<trace_event> events;
+#if defined(TORI_ENABLE_TRACE)
+      auto& r = trace_registry::get();
+      std::lock_guard lock {r.mtx};
+
+      for (auto&& b : r.buffers) {
+        constexpr auto cap = trace_buffer::capacity;
+        auto h             = b->head.load(std::memory_order_acquire);
+        auto t             = b->tail.load(std::memory_order_relaxed);
+        auto first         = std::max(t, h > cap ? h - cap : 0);
+
+        std::vector<trace_event> tmp;
+        for (auto i = first; i < h; ++i) {
+          auto& slot = b->slots[i & (cap - 1)];
+          auto tag   = slot.tag.load(std::memory_order_relaxed);
+          auto info  = slot.info.load(std::memory_order_relaxed);
+          tmp.push_back(
+            {slot.timestamp.load(std::memory_order_relaxed),
+             b->thread,
+             static_cast<trace_phase>(tag & 0xff),
+             static_cast<trace_kind>(tag >> 8),
+             info ? info->obj_type : nullptr});
+        }
+
+        // discard slots overwritten while reading
+        auto h2   = b->head.load(std::memory_order_acquire);
+        auto skip = h2 > cap + first ? h2 - cap - first : 0;
+
+        // drop orphan end events
+        size_t depth = 0;
+        for (auto i = std::min<uint64_t>(skip, tmp.size()); i < tmp.size();
+             ++i) {
+          if (tmp[i].phase == trace_phase::begin)
+            ++depth;
+          else if (depth == 0)
+            continue;
+          else
+            --depth;
+          events.push_back(std::move(tmp[i]));
+        }
+      }
+#endif
+      return events;
+    }
+
+    /// Discard recorded events.
+    inline void clear_trace()
+    {
+#if defined(TORI_ENABLE_TRACE)
+      auto& r = trace_registry::get();
+      std::lock_guard lock {r.mtx};
+      for (auto&& b : r.buffers)
+        b->tail.store(
+          b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+#endif
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
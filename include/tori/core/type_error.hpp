@@ -41,6 +41,13 @@ namespace TORI_NS::detail {
     //  type_missmatch
     //  bad_type_check
     object_ptr<const Type> provided;
+
+    /// visit types
+    void visit_children(object_visitor visitor) const
+    {
+      visitor(expected);
+      visitor(provided);
+    }
   };
 
   namespace interface {
@@ -113,9 +113,15 @@ namespace TORI_NS::detail {
     auto value_type_name = create_value_type_name(
       object_type_traits<typename decltype(type_c<T>.tag())::type>::name);
 
+  /// ID of value type
   template <class T>
-  const Type value_type_initializer<T>::type {static_construct,
-                                              value_type {&value_type_name<T>}};
+  inline constexpr uint64_t value_type_id_v =
+    value_type_id(value_type_name<T>.data());
+
+  template <class T>
+  const Type value_type_initializer<T>::type {
+    static_construct,
+    value_type {&value_type_name<T>, value_type_id_v<T>}};
 
   // ------------------------------------------
   // arrow type
@@ -210,6 +216,16 @@ namespace TORI_NS::detail {
       return ptr;
     }
 
+    /// get ID of value type at compile time
+    template <class T>
+    [[nodiscard]] constexpr uint64_t value_type_id() noexcept
+    {
+      constexpr auto spec = normalize_specifier(type_c<T>);
+      constexpr auto term = get_term(get_proxy_type(spec));
+      static_assert(is_tm_value(term), "Not a value type");
+      return value_type_id_v<typename decltype(term)::type>;
+    }
+
   } // namespace interface
 
   // ------------------------------------------
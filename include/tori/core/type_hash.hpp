@@ -0,0 +1,132 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Structural hash of types
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "type_gen.hpp"
+#  include "dynamic_typing.hpp"
+#endif
+
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace TORI_NS::detail {
+
+  /// combine hash values
+  [[nodiscard]] constexpr uint64_t
+    hash_combine(uint64_t seed, uint64_t value) noexcept
+  {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+  }
+
+  /// finalizer of splitmix64
+  [[nodiscard]] constexpr uint64_t hash_mix(uint64_t x) noexcept
+  {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  [[nodiscard]] inline uint64_t
+    compute_type_hash(const type_object_value& tp, uint64_t index);
+
+  [[nodiscard]] inline uint64_t hash_type_impl(const type_object_value& tp)
+  {
+    auto& storage = _get_storage(tp);
+
+    if (auto h = storage.hash.load(std::memory_order_relaxed))
+      return h;
+
+    auto h = compute_type_hash(tp, storage.index);
+
+    // 0 is reserved for empty cache
+    if (TORI_UNLIKELY(h == 0))
+      h = 1;
+
+    // other threads store the same value
+    storage.hash.store(h, std::memory_order_relaxed);
+    return h;
+  }
+
+  [[nodiscard]] inline uint64_t
+    compute_type_hash(const type_object_value& tp, uint64_t index)
+  {
+    if (auto value = get_if<value_type>(&tp))
+      return hash_mix(hash_combine(value->id, index));
+
+    if (auto var = get_if<var_type>(&tp))
+      return hash_mix(hash_combine(var->id, index));
+
+    if (auto arrow = get_if<arrow_type>(&tp)) {
+      auto h = hash_combine(index, hash_type_impl(*arrow->captured));
+      return hash_mix(hash_combine(h, hash_type_impl(*arrow->returns)));
+    }
+
+    TORI_UNREACHABLE();
+  }
+
+  namespace interface {
+
+    /// Get structural hash of type.
+    /// Hash is computed once and cached in the type object.
+    /// \notes Returns 0 for null.
+    [[nodiscard]] inline uint64_t hash_type(const object_ptr<const Type>& tp)
+    {
+      if (!tp)
+        return 0;
+      return hash_type_impl(*tp);
+    }
+
+    /// Hash functor of types
+    struct type_hash
+    {
+      [[nodiscard]] size_t operator()(const object_ptr<const Type>& tp) const
+      {
+        return static_cast<size_t>(hash_type(tp));
+      }
+    };
+
+    /// Equality functor of types.
+    /// Compares hashes before structure of types.
+    struct type_equal
+    {
+      [[nodiscard]] bool operator()(
+        const object_ptr<const Type>& lhs,
+        const object_ptr<const Type>& rhs) const
+      {
+        if (lhs == rhs)
+          return true;
+        if (hash_type(lhs) != hash_type(rhs))
+          return false;
+        return same_type(lhs, rhs);
+      }
+    };
+
+    /// Unordered map keyed by types
+    template <class T>
+    using type_map =
+      std::unordered_map<object_ptr<const Type>, T, type_hash, type_equal>;
+
+    /// Unordered set of types
+    using type_set =
+      std::unordered_set<object_ptr<const Type>, type_hash, type_equal>;
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
+
+namespace std {
+
+  /// Structural hash of types
+  template <>
+  struct hash<TORI_NS::object_ptr<const TORI_NS::Type>>
+    : TORI_NS::type_hash
+  {
+  };
+
+} // namespace std
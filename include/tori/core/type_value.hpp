@@ -9,10 +9,51 @@
 #endif
 
 #include <array>
+#include <atomic>
 #include <cstring>
 
 namespace TORI_NS::detail {
 
+  // ------------------------------------------
+  // name compare kernels
+
+  // clang-format off
+
+  TORI_TARGET_PUSH(sse2)
+
+  /// compare 32 byte buffers (SSE2)
+  inline bool
+    value_type_name_equal_sse2(const char* lhs, const char* rhs) noexcept
+  {
+    auto l0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + 0));
+    auto l1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + 16));
+    auto r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + 0));
+    auto r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + 16));
+    auto cmp = _mm_and_si128(_mm_cmpeq_epi8(l0, r0), _mm_cmpeq_epi8(l1, r1));
+    return _mm_movemask_epi8(cmp) == 0xffff;
+  }
+
+  TORI_TARGET_POP
+
+  TORI_TARGET_PUSH(avx2)
+
+  /// compare 32 byte buffers (AVX2)
+  inline bool
+    value_type_name_equal_avx2(const char* lhs, const char* rhs) noexcept
+  {
+    auto l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs));
+    auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs));
+    auto cmp = _mm256_cmpeq_epi8(l, r);
+    auto mask = static_cast<unsigned>(_mm256_movemask_epi8(cmp));
+    // clear upper bits for other SIMD operations
+    _mm256_zeroupper();
+    return mask == 0xffffffffU;
+  }
+
+  TORI_TARGET_POP
+
+  // clang-format on
+
   // ------------------------------------------
   // TypeValue union values
 
@@ -25,6 +66,9 @@ namespace TORI_NS::detail {
     using buffer_type = std::array<char, buffer_size>;
     /// buffer
     const buffer_type* name;
+    /// ID (hash of name). equal names have equal IDs, but different names
+    /// can share an ID.
+    uint64_t id;
 
     /// get C-style string
     const char* c_str() const
@@ -33,51 +77,48 @@ namespace TORI_NS::detail {
     }
 
     /// compare two value types
-    static bool compare(const value_type& lhs, const value_type& rhs)
+    static bool compare(const value_type& lhs, const value_type& rhs) noexcept
     {
-      if constexpr (has_AVX2 && buffer_size == 32) {
-        // AVX2
-        // buffers should be aligned as 32byte
-        // load each buffers into 256-bit registers
-        auto ymm0 =
-          _mm256_load_si256(reinterpret_cast<const __m256i*>(lhs.name->data()));
-        auto ymm1 =
-          _mm256_load_si256(reinterpret_cast<const __m256i*>(rhs.name->data()));
-        // compare
-        auto cmpeq = _mm256_cmpeq_epi8(ymm0, ymm1);
-        // get mask
-        unsigned mask = _mm256_movemask_epi8(cmpeq);
-        // clear upper bits for other SIMD operations
-        _mm256_zeroupper();
-        return mask == 0xffffffffU;
-      } else if constexpr (has_AVX && buffer_size == 32) {
-        // AVX
-        // buffers should be aligned as 16byte
-        // load buffer into 2 xmm registers
-        auto xmm0 = _mm_load_si128(
-          reinterpret_cast<const __m128i*>(lhs.name->data() + 0));
-        auto xmm1 = _mm_load_si128(
-          reinterpret_cast<const __m128i*>(lhs.name->data() + 16));
-        // compare registers to another buffer on memory
-        auto cmp1 = _mm_cmpeq_epi8(
-          xmm0, *reinterpret_cast<const __m128i*>(rhs.name->data() + 0));
-        auto cmp2 = _mm_cmpeq_epi8(
-          xmm1, *reinterpret_cast<const __m128i*>(rhs.name->data() + 16));
-        // get cmp result
-        auto cmp = _mm_and_si128(cmp1, cmp2);
-        // get mask
-        auto mask = _mm_movemask_epi8(cmp);
-        return mask == 0xffffU;
-      } else {
-        // fallback to memcmp
-        return std::memcmp(        //
-                 lhs.name->data(), //
-                 rhs.name->data(), //
-                 buffer_size) == 0;
+      // fast reject
+      if (lhs.id != rhs.id)
+        return false;
+      // IDs can collide; compare names (buffers are zero filled)
+      return lhs.name == rhs.name || compare_name(*lhs.name, *rhs.name);
+    }
+
+    /// compare name buffers
+    static bool
+      compare_name(const buffer_type& lhs, const buffer_type& rhs) noexcept
+    {
+      static_assert(buffer_size == 32);
+      switch (get_simd_level()) {
+        case simd_level::avx2:
+          return value_type_name_equal_avx2(lhs.data(), rhs.data());
+        case simd_level::avx:
+        case simd_level::sse2:
+          return value_type_name_equal_sse2(lhs.data(), rhs.data());
+        case simd_level::none:
+          break;
       }
+      return std::memcmp(lhs.data(), rhs.data(), buffer_size) == 0;
     }
   };
 
+  /// Get ID of value type name.
+  /// 64bit FNV-1a hash of name, which is shared by static value types and
+  /// value types created at runtime.
+  [[nodiscard]] constexpr uint64_t value_type_id(const char* name) noexcept
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint64_t i = 0; i < value_type::buffer_size; ++i) {
+      if (name[i] == '\0')
+        break;
+      hash ^= static_cast<unsigned char>(name[i]);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
   /// Arrow type
   struct arrow_type
   {
@@ -125,6 +166,7 @@ namespace TORI_NS::detail {
     /// Copy constructor
     type_object_value_storage(const type_object_value_storage& other)
       : index {other.index}
+      , hash {other.hash.load(std::memory_order_relaxed)}
     {
       // copy union
       if (other.index == value_index) {
@@ -179,6 +221,9 @@ namespace TORI_NS::detail {
 
     // 8 byte index
     uint64_t index;
+
+    // 8 byte structural hash. Computed on first use, 0 when not available.
+    mutable std::atomic<uint64_t> hash = {0};
   };
 
   /// Base class for TypeValue
@@ -221,6 +266,15 @@ namespace TORI_NS::detail {
       : base {other}
     {
     }
+
+    /// visit argument and return type of arrow
+    void visit_children(object_visitor visitor) const
+    {
+      if (index == arrow_index) {
+        visitor(arrow.captured);
+        visitor(arrow.returns);
+      }
+    }
   };
 
   // ------------------------------------------
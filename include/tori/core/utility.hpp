@@ -7,6 +7,7 @@
 #  include "../config/config.hpp"
 #  include "object_ptr.hpp"
 #  include "object_cast.hpp"
+#  include "object_ref.hpp"
 #endif
 
 namespace TORI_NS::detail {
@@ -33,14 +34,19 @@ namespace TORI_NS::detail {
       return static_object_cast<T>(std::move(tmp));
     }
 
-    /// check type
-    template <class T, class U>
-    void check_type(const object_ptr<U>& obj)
+    /// Clone
+    /// \see clone(const object_ptr<T>&)
+    template <class T>
+    [[nodiscard]] object_ptr<T> clone(const object_ref<T>& obj)
     {
-      auto t1 = object_type<T>();
-      auto t2 = type_of(obj);
-      if (TORI_UNLIKELY(!same_type(t1, t2)))
-        throw type_error::bad_type_check(t1, t2, obj);
+      TORI_ASSERT(obj);
+
+      object_ptr tmp = _get_storage(obj).info_table()->clone(obj.get());
+
+      if (TORI_UNLIKELY(!tmp))
+        throw std::bad_alloc();
+
+      return static_object_cast<T>(std::move(tmp));
     }
 
   } // namespace interface
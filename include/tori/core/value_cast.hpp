@@ -6,6 +6,7 @@
 #if !defined(TORI_NO_LOCAL_INCLUDE)
 #  include "object_ptr.hpp"
 #  include "object_cast.hpp"
+#  include "object_ref.hpp"
 #  include "dynamic_typing.hpp"
 #  include "bad_value_cast.hpp"
 #endif
@@ -80,6 +81,38 @@ namespace TORI_NS::detail {
       return nullptr;
     }
 
+    /// value_cast
+    ///
+    /// dynamically cast borrowed object to specified value type.
+    /// \throws bad_value_cast when fail.
+    template <class T, class U>
+    [[nodiscard]] object_ref<propagate_const_t<T, U>>
+      value_cast(const object_ref<U>& obj)
+    {
+      if (TORI_LIKELY(obj && has_type<T>(obj))) {
+        using To = typename decltype(
+          get_object_type(normalize_specifier(type_c<T>)))::type;
+        return static_object_cast<propagate_const_t<To, U>>(obj);
+      }
+      throw bad_value_cast(obj ? get_type(obj) : nullptr, object_type<T>());
+    }
+
+    /// value_cast_if
+    ///
+    /// dynamically cast borrowed object to specified value type.
+    /// \returns nullptr when fail.
+    template <class T, class U>
+    [[nodiscard]] object_ref<propagate_const_t<T, U>>
+      value_cast_if(const object_ref<U>& obj) noexcept
+    {
+      if (TORI_LIKELY(obj && has_type<T>(obj))) {
+        using To = typename decltype(
+          get_object_type(normalize_specifier(type_c<T>)))::type;
+        return static_object_cast<propagate_const_t<To, U>>(obj);
+      }
+      return nullptr;
+    }
+
   } // namespace interface
 
 } // namespace TORI_NS::detail
@@ -0,0 +1,171 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file weak_object_ptr
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object_ptr.hpp"
+#  include "weak_reference.hpp"
+#endif
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    // ------------------------------------------
+    // weak_object_ptr
+
+    /// Weak reference to heap-allocated object.
+    ///
+    /// Does not keep object alive. lock() returns new object_ptr while the
+    /// object exists, and nullptr after it is destroyed.
+    /// Objects without weak reference have no extra cost; control blocks are
+    /// allocated in a side table when first weak reference is taken.
+    template <class T = Object>
+    class weak_object_ptr
+    {
+      template <class U>
+      friend class weak_object_ptr;
+
+    public:
+      // value type
+      using element_type = T;
+      // pointer
+      using pointer = T*;
+
+      /// Constructor
+      constexpr weak_object_ptr() noexcept
+        : m_ref {nullptr}
+      {
+      }
+
+      /// Constructor
+      constexpr weak_object_ptr(nullptr_t) noexcept
+        : m_ref {nullptr}
+      {
+      }
+
+      /// Construct from object_ptr
+      /// \throws std::bad_alloc
+      template <
+        class U,
+        class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+      weak_object_ptr(const object_ptr<U>& obj)
+        : m_ref {nullptr}
+      {
+        if (auto p = _get_storage(obj).get())
+          m_ref = get_weak_reference_table().acquire(p);
+      }
+
+      /// Copy constructor
+      weak_object_ptr(const weak_object_ptr& other) noexcept
+        : m_ref {other.m_ref}
+      {
+        if (m_ref)
+          get_weak_reference_table().add_ref(m_ref);
+      }
+
+      /// Move constructor
+      weak_object_ptr(weak_object_ptr&& other) noexcept
+        : m_ref {other.m_ref}
+      {
+        other.m_ref = nullptr;
+      }
+
+      /// Copy convert constructor
+      template <
+        class U,
+        class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+      weak_object_ptr(const weak_object_ptr<U>& other) noexcept
+        : m_ref {other.m_ref}
+      {
+        if (m_ref)
+          get_weak_reference_table().add_ref(m_ref);
+      }
+
+      /// Move convert constructor
+      template <
+        class U,
+        class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+      weak_object_ptr(weak_object_ptr<U>&& other) noexcept
+        : m_ref {other.m_ref}
+      {
+        other.m_ref = nullptr;
+      }
+
+      /// Destructor
+      ~weak_object_ptr() noexcept
+      {
+        if (m_ref)
+          get_weak_reference_table().release(m_ref);
+      }
+
+      /// operator=
+      weak_object_ptr& operator=(const weak_object_ptr& other) noexcept
+      {
+        weak_object_ptr(other).swap(*this);
+        return *this;
+      }
+
+      /// operator=
+      weak_object_ptr& operator=(weak_object_ptr&& other) noexcept
+      {
+        weak_object_ptr(std::move(other)).swap(*this);
+        return *this;
+      }
+
+      /// operator=
+      template <class U>
+      weak_object_ptr& operator=(const object_ptr<U>& obj)
+      {
+        weak_object_ptr(obj).swap(*this);
+        return *this;
+      }
+
+      /// Get new reference to object.
+      /// \returns nullptr when object is already destroyed.
+      [[nodiscard]] object_ptr<T> lock() const noexcept
+      {
+        if (!m_ref)
+          return nullptr;
+        // reference count is already incremented
+        auto p = get_weak_reference_table().lock(m_ref);
+        return reinterpret_cast<pointer>(
+          const_cast<propagate_const_t<Object*, pointer>>(p));
+      }
+
+      /// Object destroyed (or null)?
+      [[nodiscard]] bool expired() const noexcept
+      {
+        return !m_ref || get_weak_reference_table().expired(m_ref);
+      }
+
+      /// reset to null
+      void reset() noexcept
+      {
+        weak_object_ptr().swap(*this);
+      }
+
+      /// swap data
+      void swap(weak_object_ptr& other) noexcept
+      {
+        std::swap(m_ref, other.m_ref);
+      }
+
+    private:
+      /// control block
+      weak_reference* m_ref;
+    };
+
+    // ------------------------------------------
+    // deduction guides
+
+    template <class T>
+    weak_object_ptr(const object_ptr<T>&)->weak_object_ptr<T>;
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
\ No newline at end of file
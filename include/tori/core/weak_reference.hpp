@@ -0,0 +1,149 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Side table of weak references
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../config/config.hpp"
+#  include "object.hpp"
+#endif
+
+#include <mutex>
+#include <unordered_map>
+
+namespace TORI_NS::detail {
+
+  /// control block shared by weak_object_ptr to single object
+  struct weak_reference
+  {
+    /// object (null after destruction)
+    const Object* obj;
+    /// number of weak_object_ptr
+    size_t weak_count;
+  };
+
+  /// Table of objects which have weak references.
+  ///
+  /// Entries are created on demand, and objects in the table have
+  /// `weak_flag` in their reference count so destruction only visits the
+  /// table when needed.
+  class weak_reference_table
+  {
+  public:
+    /// get (or create) control block of object
+    [[nodiscard]] weak_reference* acquire(const Object* obj)
+    {
+      std::lock_guard lock {m_mtx};
+
+      auto [it, inserted] = m_refs.emplace(obj, nullptr);
+
+      if (inserted) {
+        try {
+          it->second = new weak_reference {obj, 0};
+        } catch (...) {
+          m_refs.erase(it);
+          throw;
+        }
+        // static objects are never destroyed
+        if (obj->refcount.load() != 0)
+          obj->refcount.set_weak_flag();
+      }
+
+      ++it->second->weak_count;
+      return it->second;
+    }
+
+    /// add weak reference
+    void add_ref(weak_reference* ref) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+      ++ref->weak_count;
+    }
+
+    /// remove weak reference
+    void release(weak_reference* ref) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+
+      if (--ref->weak_count != 0)
+        return;
+
+      if (ref->obj) {
+        m_refs.erase(ref->obj);
+        ref->obj->refcount.clear_weak_flag();
+      }
+      delete ref;
+    }
+
+    /// take new reference to object
+    /// \returns nullptr when object is already destroyed.
+    [[nodiscard]] const Object* lock(const weak_reference* ref) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+
+      // object can be destroyed after reaching zero, but not before
+      // expire() is called.
+      auto obj = ref->obj;
+
+      if (!obj)
+        return nullptr;
+
+      if (obj->refcount.load() == 0)
+        return obj; // static
+
+#if defined(TORI_ENABLE_GC)
+      // keep object alive in current marking
+      gc_write_barrier(obj);
+      return obj;
+#else
+      if (obj->refcount.increment_if_nonzero())
+        return obj;
+
+      return nullptr;
+#endif
+    }
+
+    /// object expired?
+    [[nodiscard]] bool expired(const weak_reference* ref) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+
+      if (!ref->obj)
+        return true;
+
+      // zero with flags: being destroyed
+      auto& refcount = ref->obj->refcount;
+      auto v = refcount.load();
+      return v != 0 && (v & refcount.count_mask) == 0;
+    }
+
+    /// detach object from weak references.
+    /// called before destroying object which has `weak_flag`.
+    void expire(const Object* obj) noexcept
+    {
+      std::lock_guard lock {m_mtx};
+
+      auto it = m_refs.find(obj);
+      if (it == m_refs.end())
+        return;
+
+      it->second->obj = nullptr;
+      m_refs.erase(it);
+    }
+
+  private:
+    std::mutex m_mtx;
+    std::unordered_map<const Object*, weak_reference*> m_refs;
+  };
+
+  /// global weak reference table
+  [[nodiscard]] inline weak_reference_table& get_weak_reference_table()
+  {
+    // never destroyed; objects can be released after static destructors.
+    static auto table = new weak_reference_table();
+    return *table;
+  }
+
+} // namespace TORI_NS::detail
\ No newline at end of file
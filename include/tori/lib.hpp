@@ -10,4 +10,8 @@
 #include "lib/identity.hpp"
 #include "lib/binary_operator.hpp"
 #include "lib/if.hpp"
+#include "lib/array.hpp"
+#include "lib/list.hpp"
+#include "lib/foldable.hpp"
+#include "lib/optimize.hpp"
 #include "lib/util.hpp"
@@ -0,0 +1,858 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Array
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../core.hpp"
+#  include "primitive.hpp"
+#  include "binary_operator.hpp"
+#endif
+
+#include <new>
+#include <vector>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+namespace TORI_NS::detail {
+
+  // ------------------------------------------
+  // array_object_value
+
+  /// Contiguous array of primitive values.
+  ///
+  /// Length and pointer live in the Box, and elements are stored in a
+  /// separate buffer aligned for SIMD kernels. Objects have a fixed size in
+  /// their info table (`obj_size`), which clone, clone_at, object_size()
+  /// and the gc heap rely on, so elements are not placed inline after the
+  /// header. Bulk closures touch the buffer once per call, so the extra
+  /// pointer chase is not paid per element.
+  template <class T>
+  class array_object_value
+  {
+    static_assert(std::is_arithmetic_v<T>, "Array only supports primitives");
+
+  public:
+    /// element type
+    using value_type = T;
+
+    /// alignment of buffer
+    static constexpr size_t alignment = 32;
+
+    /// Ctor
+    array_object_value() noexcept
+      : m_ptr {nullptr}
+      , m_size {0}
+    {
+    }
+
+    /// Ctor
+    /// \param size number of zero-initialized elements
+    /// \notes Box uses list-initialization, so this class does not have
+    /// initializer_list constructor. Use iterators instead.
+    explicit array_object_value(size_t size)
+      : m_ptr {allocate(size)}
+      , m_size {size}
+    {
+      std::fill_n(m_ptr, m_size, T());
+    }
+
+    /// Ctor
+    array_object_value(size_t size, T value)
+      : m_ptr {allocate(size)}
+      , m_size {size}
+    {
+      std::fill_n(m_ptr, m_size, value);
+    }
+
+    /// Ctor
+    template <
+      class InputIterator,
+      class = std::enable_if_t<!std::is_integral_v<InputIterator>>>
+    array_object_value(InputIterator first, InputIterator last)
+    {
+      std::vector<T> tmp(first, last);
+      m_size = tmp.size();
+      m_ptr = allocate(m_size);
+      std::copy(tmp.begin(), tmp.end(), m_ptr);
+    }
+
+    /// Copy ctor
+    array_object_value(const array_object_value& other)
+      : m_ptr {allocate(other.m_size)}
+      , m_size {other.m_size}
+    {
+      std::copy(other.begin(), other.end(), m_ptr);
+    }
+
+    /// Move ctor
+    array_object_value(array_object_value&& other) noexcept
+      : m_ptr {other.m_ptr}
+      , m_size {other.m_size}
+    {
+      other.m_ptr = nullptr;
+      other.m_size = 0;
+    }
+
+    /// operator=
+    array_object_value& operator=(const array_object_value& other)
+    {
+      array_object_value tmp(other);
+      swap(tmp);
+      return *this;
+    }
+
+    /// operator=
+    array_object_value& operator=(array_object_value&& other) noexcept
+    {
+      array_object_value tmp(std::move(other));
+      swap(tmp);
+      return *this;
+    }
+
+    /// Dtor
+    ~array_object_value() noexcept
+    {
+      deallocate(m_ptr);
+    }
+
+    /// swap
+    void swap(array_object_value& other) noexcept
+    {
+      std::swap(m_ptr, other.m_ptr);
+      std::swap(m_size, other.m_size);
+    }
+
+    /// size
+    [[nodiscard]] size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+    /// empty
+    [[nodiscard]] bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    /// data
+    [[nodiscard]] T* data() noexcept
+    {
+      return m_ptr;
+    }
+
+    /// data
+    [[nodiscard]] const T* data() const noexcept
+    {
+      return m_ptr;
+    }
+
+    /// operator[]
+    [[nodiscard]] T& operator[](size_t n) noexcept
+    {
+      TORI_ASSERT(n < m_size);
+      return m_ptr[n];
+    }
+
+    /// operator[]
+    [[nodiscard]] const T& operator[](size_t n) const noexcept
+    {
+      TORI_ASSERT(n < m_size);
+      return m_ptr[n];
+    }
+
+    /// begin
+    [[nodiscard]] T* begin() noexcept
+    {
+      return m_ptr;
+    }
+
+    /// begin
+    [[nodiscard]] const T* begin() const noexcept
+    {
+      return m_ptr;
+    }
+
+    /// end
+    [[nodiscard]] T* end() noexcept
+    {
+      return m_ptr + m_size;
+    }
+
+    /// end
+    [[nodiscard]] const T* end() const noexcept
+    {
+      return m_ptr + m_size;
+    }
+
+    /// size of buffer
+    [[nodiscard]] size_t heap_size() const noexcept
+    {
+      return m_size * sizeof(T);
+    }
+
+  private:
+    /// register heap_size() for object_size()
+    static inline const bool heap_size_registered =
+      register_heap_size<Box<array_object_value>>();
+
+    static T* allocate(size_t size)
+    {
+      (void)heap_size_registered;
+      if (size == 0)
+        return nullptr;
+      return static_cast<T*>(
+        ::operator new(size * sizeof(T), std::align_val_t {alignment}));
+    }
+
+    static void deallocate(T* ptr) noexcept
+    {
+      if (ptr)
+        ::operator delete(ptr, std::align_val_t {alignment});
+    }
+
+  private:
+    /// buffer
+    T* m_ptr;
+    /// number of elements
+    size_t m_size;
+  };
+
+  namespace interface {
+
+    /// Array of primitive box type T
+    template <class T>
+    using Array = Box<array_object_value<typename T::value_type>>;
+
+    // clang-format off
+
+    using Int8Array   = Array<Int8>;
+    using Int16Array  = Array<Int16>;
+    using Int32Array  = Array<Int32>;
+    using Int64Array  = Array<Int64>;
+    using UInt8Array  = Array<UInt8>;
+    using UInt16Array = Array<UInt16>;
+    using UInt32Array = Array<UInt32>;
+    using UInt64Array = Array<UInt64>;
+    using FloatArray  = Array<Float>;
+    using DoubleArray = Array<Double>;
+
+    using CharArray   = Int8Array;
+    using ShortArray  = Int16Array;
+    using IntArray    = Int32Array;
+    using LongArray   = Int64Array;
+
+    using UCharArray  = UInt8Array;
+    using UShortArray = UInt16Array;
+    using UIntArray   = UInt32Array;
+    using ULongArray  = UInt64Array;
+
+    using BoolArray   = Array<Bool>;
+
+    // clang-format on
+
+  } // namespace interface
+
+  // ------------------------------------------
+  // SIMD kernels
+
+  /// identity element for vectorized reduction
+  template <template <class> class E>
+  struct simd_reduce_identity
+  {
+    static constexpr bool enabled = false;
+  };
+
+  template <>
+  struct simd_reduce_identity<std::plus>
+  {
+    static constexpr bool enabled = true;
+    static constexpr int value = 0;
+  };
+
+  template <>
+  struct simd_reduce_identity<std::multiplies>
+  {
+    static constexpr bool enabled = true;
+    static constexpr int value = 1;
+  };
+
+  // Kernels are instantiated once for each instruction set in namespaces
+  // below. `vec<T>` and `vop<T, E>` are specialized for types and operators
+  // the instruction set supports, and everything else falls back to scalar
+  // loops. Dispatchers select one of them by get_simd_level().
+
+#define TORI_SIMD_KERNELS                                                      \
+  template <class T>                                                           \
+  struct vec                                                                   \
+  {                                                                            \
+    static constexpr size_t width = 0;                                         \
+  };                                                                           \
+                                                                               \
+  template <class T, template <class> class E>                                 \
+  struct vop                                                                   \
+  {                                                                            \
+    static constexpr bool enabled = false;                                     \
+  };                                                                           \
+                                                                               \
+  template <class T, template <class> class E>                                 \
+  void map_kernel(T c, const T* src, T* dst, size_t n) noexcept                \
+  {                                                                            \
+    size_t i = 0;                                                              \
+    if constexpr (vop<T, E>::enabled) {                                        \
+      using V = vec<T>;                                                        \
+      auto vc = V::set1(c);                                                    \
+      for (; i + V::width <= n; i += V::width)                                 \
+        V::store(dst + i, vop<T, E>::apply(vc, V::load(src + i)));             \
+    }                                                                          \
+    E<T> op;                                                                   \
+    for (; i < n; ++i)                                                         \
+      dst[i] = op(c, src[i]);                                                  \
+  }                                                                            \
+                                                                               \
+  template <class T, template <class> class E>                                 \
+  void zip_kernel(const T* a, const T* b, T* dst, size_t n) noexcept           \
+  {                                                                            \
+    size_t i = 0;                                                              \
+    if constexpr (vop<T, E>::enabled) {                                        \
+      using V = vec<T>;                                                        \
+      for (; i + V::width <= n; i += V::width)                                 \
+        V::store(dst + i, vop<T, E>::apply(V::load(a + i), V::load(b + i)));   \
+    }                                                                          \
+    E<T> op;                                                                   \
+    for (; i < n; ++i)                                                         \
+      dst[i] = op(a[i], b[i]);                                                 \
+  }                                                                            \
+                                                                               \
+  template <class T, template <class> class E>                                 \
+  T fold_kernel(T init, const T* src, size_t n) noexcept                       \
+  {                                                                            \
+    E<T> op;                                                                   \
+    size_t i = 0;                                                              \
+    if constexpr (vop<T, E>::enabled && simd_reduce_identity<E>::enabled) {    \
+      using V = vec<T>;                                                        \
+      if (n >= V::width) {                                                     \
+        auto acc = V::set1(static_cast<T>(simd_reduce_identity<E>::value));    \
+        for (; i + V::width <= n; i += V::width)                               \
+          acc = vop<T, E>::apply(acc, V::load(src + i));                       \
+        alignas(32) T lanes[V::width];                                         \
+        V::store(lanes, acc);                                                  \
+        for (auto&& l : lanes)                                                 \
+          init = op(init, l);                                                  \
+      }                                                                        \
+    }                                                                          \
+    for (; i < n; ++i)                                                         \
+      init = op(init, src[i]);                                                 \
+    return init;                                                               \
+  }
+
+#define TORI_SIMD_VEC(TYPE, VEC, LOAD, STORE, SET1)             \
+  template <>                                                   \
+  struct vec<TYPE>                                              \
+  {                                                             \
+    using type = VEC;                                           \
+    static constexpr size_t width = sizeof(VEC) / sizeof(TYPE); \
+    static type load(const TYPE* p) noexcept                    \
+    {                                                           \
+      return LOAD(p);                                           \
+    }                                                           \
+    static void store(TYPE* p, type v) noexcept                 \
+    {                                                           \
+      STORE(p, v);                                              \
+    }                                                           \
+    static type set1(TYPE v) noexcept                           \
+    {                                                           \
+      return SET1(v);                                           \
+    }                                                           \
+  };
+
+#define TORI_SIMD_OP(TYPE, OP, FUNC)                 \
+  template <>                                        \
+  struct vop<TYPE, OP>                               \
+  {                                                  \
+    static constexpr bool enabled = true;            \
+    using vector = typename vec<TYPE>::type;         \
+    static vector apply(vector a, vector b) noexcept \
+    {                                                \
+      return FUNC(a, b);                             \
+    }                                                \
+  };
+
+#define TORI_SIMD_LOAD256(p) _mm256_loadu_si256((const __m256i*)(p))
+#define TORI_SIMD_STORE256(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define TORI_SIMD_LOAD128(p) _mm_loadu_si128((const __m128i*)(p))
+#define TORI_SIMD_STORE128(p, v) _mm_storeu_si128((__m128i*)(p), v)
+
+  // clang-format off
+
+  /// scalar kernels
+  namespace simd_none {
+    TORI_SIMD_KERNELS
+  } // namespace simd_none
+
+  TORI_TARGET_PUSH(sse2)
+
+  /// SSE2 kernels
+  namespace simd_sse2 {
+    TORI_SIMD_KERNELS
+    TORI_SIMD_VEC(float,    __m128,  _mm_loadu_ps,      _mm_storeu_ps,      _mm_set1_ps)
+    TORI_SIMD_VEC(double,   __m128d, _mm_loadu_pd,      _mm_storeu_pd,      _mm_set1_pd)
+    TORI_SIMD_VEC(int32_t,  __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi32)
+    TORI_SIMD_VEC(uint32_t, __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi32)
+    TORI_SIMD_VEC(int64_t,  __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi64x)
+    TORI_SIMD_VEC(uint64_t, __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi64x)
+    TORI_SIMD_OP(float,    std::plus,       _mm_add_ps)
+    TORI_SIMD_OP(float,    std::minus,      _mm_sub_ps)
+    TORI_SIMD_OP(float,    std::multiplies, _mm_mul_ps)
+    TORI_SIMD_OP(float,    std::divides,    _mm_div_ps)
+    TORI_SIMD_OP(double,   std::plus,       _mm_add_pd)
+    TORI_SIMD_OP(double,   std::minus,      _mm_sub_pd)
+    TORI_SIMD_OP(double,   std::multiplies, _mm_mul_pd)
+    TORI_SIMD_OP(double,   std::divides,    _mm_div_pd)
+    TORI_SIMD_OP(int32_t,  std::plus,       _mm_add_epi32)
+    TORI_SIMD_OP(int32_t,  std::minus,      _mm_sub_epi32)
+    TORI_SIMD_OP(uint32_t, std::plus,       _mm_add_epi32)
+    TORI_SIMD_OP(uint32_t, std::minus,      _mm_sub_epi32)
+    TORI_SIMD_OP(int64_t,  std::plus,       _mm_add_epi64)
+    TORI_SIMD_OP(int64_t,  std::minus,      _mm_sub_epi64)
+    TORI_SIMD_OP(uint64_t, std::plus,       _mm_add_epi64)
+    TORI_SIMD_OP(uint64_t, std::minus,      _mm_sub_epi64)
+  } // namespace simd_sse2
+
+  TORI_TARGET_POP
+
+  TORI_TARGET_PUSH(avx)
+
+  /// AVX kernels. Integer vectors stay 128-bit with SSE4.1.
+  namespace simd_avx {
+    TORI_SIMD_KERNELS
+    TORI_SIMD_VEC(float,    __m256,  _mm256_loadu_ps,   _mm256_storeu_ps,   _mm256_set1_ps)
+    TORI_SIMD_VEC(double,   __m256d, _mm256_loadu_pd,   _mm256_storeu_pd,   _mm256_set1_pd)
+    TORI_SIMD_VEC(int32_t,  __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi32)
+    TORI_SIMD_VEC(uint32_t, __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi32)
+    TORI_SIMD_VEC(int64_t,  __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi64x)
+    TORI_SIMD_VEC(uint64_t, __m128i, TORI_SIMD_LOAD128, TORI_SIMD_STORE128, _mm_set1_epi64x)
+    TORI_SIMD_OP(float,    std::plus,       _mm256_add_ps)
+    TORI_SIMD_OP(float,    std::minus,      _mm256_sub_ps)
+    TORI_SIMD_OP(float,    std::multiplies, _mm256_mul_ps)
+    TORI_SIMD_OP(float,    std::divides,    _mm256_div_ps)
+    TORI_SIMD_OP(double,   std::plus,       _mm256_add_pd)
+    TORI_SIMD_OP(double,   std::minus,      _mm256_sub_pd)
+    TORI_SIMD_OP(double,   std::multiplies, _mm256_mul_pd)
+    TORI_SIMD_OP(double,   std::divides,    _mm256_div_pd)
+    TORI_SIMD_OP(int32_t,  std::plus,       _mm_add_epi32)
+    TORI_SIMD_OP(int32_t,  std::minus,      _mm_sub_epi32)
+    TORI_SIMD_OP(int32_t,  std::multiplies, _mm_mullo_epi32)
+    TORI_SIMD_OP(uint32_t, std::plus,       _mm_add_epi32)
+    TORI_SIMD_OP(uint32_t, std::minus,      _mm_sub_epi32)
+    TORI_SIMD_OP(uint32_t, std::multiplies, _mm_mullo_epi32)
+    TORI_SIMD_OP(int64_t,  std::plus,       _mm_add_epi64)
+    TORI_SIMD_OP(int64_t,  std::minus,      _mm_sub_epi64)
+    TORI_SIMD_OP(uint64_t, std::plus,       _mm_add_epi64)
+    TORI_SIMD_OP(uint64_t, std::minus,      _mm_sub_epi64)
+  } // namespace simd_avx
+
+  TORI_TARGET_POP
+
+  TORI_TARGET_PUSH(avx2)
+
+  /// AVX2 kernels
+  namespace simd_avx2 {
+    TORI_SIMD_KERNELS
+    TORI_SIMD_VEC(float,    __m256,  _mm256_loadu_ps,   _mm256_storeu_ps,   _mm256_set1_ps)
+    TORI_SIMD_VEC(double,   __m256d, _mm256_loadu_pd,   _mm256_storeu_pd,   _mm256_set1_pd)
+    TORI_SIMD_VEC(int32_t,  __m256i, TORI_SIMD_LOAD256, TORI_SIMD_STORE256, _mm256_set1_epi32)
+    TORI_SIMD_VEC(uint32_t, __m256i, TORI_SIMD_LOAD256, TORI_SIMD_STORE256, _mm256_set1_epi32)
+    TORI_SIMD_VEC(int64_t,  __m256i, TORI_SIMD_LOAD256, TORI_SIMD_STORE256, _mm256_set1_epi64x)
+    TORI_SIMD_VEC(uint64_t, __m256i, TORI_SIMD_LOAD256, TORI_SIMD_STORE256, _mm256_set1_epi64x)
+    TORI_SIMD_OP(float,    std::plus,       _mm256_add_ps)
+    TORI_SIMD_OP(float,    std::minus,      _mm256_sub_ps)
+    TORI_SIMD_OP(float,    std::multiplies, _mm256_mul_ps)
+    TORI_SIMD_OP(float,    std::divides,    _mm256_div_ps)
+    TORI_SIMD_OP(double,   std::plus,       _mm256_add_pd)
+    TORI_SIMD_OP(double,   std::minus,      _mm256_sub_pd)
+    TORI_SIMD_OP(double,   std::multiplies, _mm256_mul_pd)
+    TORI_SIMD_OP(double,   std::divides,    _mm256_div_pd)
+    TORI_SIMD_OP(int32_t,  std::plus,       _mm256_add_epi32)
+    TORI_SIMD_OP(int32_t,  std::minus,      _mm256_sub_epi32)
+    TORI_SIMD_OP(int32_t,  std::multiplies, _mm256_mullo_epi32)
+    TORI_SIMD_OP(uint32_t, std::plus,       _mm256_add_epi32)
+    TORI_SIMD_OP(uint32_t, std::minus,      _mm256_sub_epi32)
+    TORI_SIMD_OP(uint32_t, std::multiplies, _mm256_mullo_epi32)
+    TORI_SIMD_OP(int64_t,  std::plus,       _mm256_add_epi64)
+    TORI_SIMD_OP(int64_t,  std::minus,      _mm256_sub_epi64)
+    TORI_SIMD_OP(uint64_t, std::plus,       _mm256_add_epi64)
+    TORI_SIMD_OP(uint64_t, std::minus,      _mm256_sub_epi64)
+  } // namespace simd_avx2
+
+  TORI_TARGET_POP
+
+  // clang-format on
+
+#undef TORI_SIMD_LOAD256
+#undef TORI_SIMD_STORE256
+#undef TORI_SIMD_LOAD128
+#undef TORI_SIMD_STORE128
+#undef TORI_SIMD_VEC
+#undef TORI_SIMD_OP
+#undef TORI_SIMD_KERNELS
+
+  /// dst[i] = E(c, src[i])
+  template <class T, template <class> class E>
+  void array_map_kernel(T c, const T* src, T* dst, size_t n) noexcept
+  {
+    switch (get_simd_level()) {
+      case simd_level::avx2:
+        return simd_avx2::map_kernel<T, E>(c, src, dst, n);
+      case simd_level::avx:
+        return simd_avx::map_kernel<T, E>(c, src, dst, n);
+      case simd_level::sse2:
+        return simd_sse2::map_kernel<T, E>(c, src, dst, n);
+      case simd_level::none:
+        break;
+    }
+    return simd_none::map_kernel<T, E>(c, src, dst, n);
+  }
+
+  /// dst[i] = E(a[i], b[i])
+  template <class T, template <class> class E>
+  void array_zip_kernel(const T* a, const T* b, T* dst, size_t n) noexcept
+  {
+    switch (get_simd_level()) {
+      case simd_level::avx2:
+        return simd_avx2::zip_kernel<T, E>(a, b, dst, n);
+      case simd_level::avx:
+        return simd_avx::zip_kernel<T, E>(a, b, dst, n);
+      case simd_level::sse2:
+        return simd_sse2::zip_kernel<T, E>(a, b, dst, n);
+      case simd_level::none:
+        break;
+    }
+    return simd_none::zip_kernel<T, E>(a, b, dst, n);
+  }
+
+  /// E(...E(E(init, src[0]), src[1])..., src[n-1])
+  /// \notes Associative operators are reduced in vector lanes, so rounding
+  /// of floating point results may differ from sequential order and between
+  /// SIMD levels.
+  template <class T, template <class> class E>
+  [[nodiscard]] T array_fold_kernel(T init, const T* src, size_t n) noexcept
+  {
+    switch (get_simd_level()) {
+      case simd_level::avx2:
+        return simd_avx2::fold_kernel<T, E>(init, src, n);
+      case simd_level::avx:
+        return simd_avx::fold_kernel<T, E>(init, src, n);
+      case simd_level::sse2:
+        return simd_sse2::fold_kernel<T, E>(init, src, n);
+      case simd_level::none:
+        break;
+    }
+    return simd_none::fold_kernel<T, E>(init, src, n);
+  }
+
+  /// dst[i] = E(dst[i-1], src[i]), dst[-1] = init
+  template <class T, template <class> class E>
+  void array_scan_kernel(T init, const T* src, T* dst, size_t n) noexcept
+  {
+    E<T> op;
+    for (size_t i = 0; i < n; ++i)
+      dst[i] = init = op(init, src[i]);
+  }
+
+  // ------------------------------------------
+  // BinaryOperator detection
+
+  /// BinaryOperator functor tag
+  template <template <class> class E>
+  struct binary_operator_tag
+  {
+    template <class T>
+    using op = E<T>;
+  };
+
+  /// Call `f(binary_operator_tag<E>)` when closure is
+  /// `BinaryOperator<T, R, E>` with one of Es and has `arity`.
+  template <class T, class R, template <class> class... Es, class F>
+  bool match_binary_operator(
+    const object_ptr<const Object>& obj,
+    uint64_t arity,
+    F&& f)
+  {
+    auto c = static_cast<const Closure<>*>(obj.get());
+
+    if (c->arity() != arity)
+      return false;
+
+    return (
+      (get_info_table(c) == get_closure_info_table<BinaryOperator<T, R, Es>>()
+         ? (f(binary_operator_tag<Es> {}), true)
+         : false) ||
+      ...);
+  }
+
+  /// Call `f(binary_operator_tag<E>)` when closure is arithmetic
+  /// BinaryOperator on T which has `arity`.
+  template <class T, class F>
+  bool match_arith_operator(
+    const object_ptr<const Object>& obj,
+    uint64_t arity,
+    F&& f)
+  {
+    if constexpr (std::is_integral_v<typename T::value_type>)
+      return match_binary_operator<
+        T,
+        T,
+        std::plus,
+        std::minus,
+        std::multiplies,
+        std::divides,
+        std::modulus,
+        std::bit_and,
+        std::bit_or,
+        std::bit_xor>(obj, arity, std::forward<F>(f));
+    else
+      return match_binary_operator<
+        T,
+        T,
+        std::plus,
+        std::minus,
+        std::multiplies,
+        std::divides>(obj, arity, std::forward<F>(f));
+  }
+
+  /// Call `f(binary_operator_tag<E>)` when closure is comparison
+  /// BinaryOperator on T which has `arity`.
+  template <class T, class F>
+  bool match_comp_operator(
+    const object_ptr<const Object>& obj,
+    uint64_t arity,
+    F&& f)
+  {
+    return match_binary_operator<
+      T,
+      Bool,
+      std::equal_to,
+      std::not_equal_to,
+      std::greater,
+      std::less,
+      std::greater_equal,
+      std::less_equal>(obj, arity, std::forward<F>(f));
+  }
+
+  /// get value of first argument of partially applied closure
+  template <class T>
+  [[nodiscard]] auto bound_arg_value(const object_ptr<const Object>& obj)
+  {
+    auto c = static_cast<const Closure<>*>(obj.get());
+    auto a = eval_impl(c->arg(c->n_args() - 1));
+    return *static_object_cast<const T>(a);
+  }
+
+  // ------------------------------------------
+  // Array closures
+
+  namespace interface {
+
+    /// Map : (T -> U) -> Array<T> -> Array<U>
+    /// \notes Partially applied arithmetic BinaryOperator runs SIMD kernel.
+    template <class T, class U = T>
+    struct ArrayMap
+      : Function<ArrayMap<T, U>, closure<T, U>, strict<Array<T>>, Array<U>>
+    {
+      typename ArrayMap::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto xs = this->template eval_arg<1>();
+
+        auto n = xs->size();
+        auto result = make_object<Array<U>>(n);
+        auto dst = result->data();
+
+        if constexpr (std::is_same_v<T, U>) {
+          using Tp = typename T::value_type;
+          if (match_arith_operator<T>(f, 1, [&](auto tag) {
+                using tag_t = decltype(tag);
+                array_map_kernel<Tp, tag_t::template op>(
+                  bound_arg_value<T>(f), xs->data(), dst, n);
+              }))
+            return result;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+          dst[i] = *eval(f << make_object<T>((*xs)[i]));
+
+        return result;
+      }
+    };
+
+    /// ZipWith : (T -> T -> T) -> Array<T> -> Array<T> -> Array<T>
+    /// \notes Result has length of shorter input.
+    /// \notes Arithmetic BinaryOperator runs SIMD kernel.
+    template <class T>
+    struct ArrayZipWith : Function<
+                            ArrayZipWith<T>,
+                            closure<T, T, T>,
+                            strict<Array<T>>,
+                            strict<Array<T>>,
+                            Array<T>>
+    {
+      typename ArrayZipWith::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto xs = this->template eval_arg<1>();
+        auto ys = this->template eval_arg<2>();
+
+        auto n = std::min(xs->size(), ys->size());
+        auto result = make_object<Array<T>>(n);
+        auto dst = result->data();
+
+        using Tp = typename T::value_type;
+        if (match_arith_operator<T>(f, 2, [&](auto tag) {
+              using tag_t = decltype(tag);
+              array_zip_kernel<Tp, tag_t::template op>(
+                xs->data(), ys->data(), dst, n);
+            }))
+          return result;
+
+        for (size_t i = 0; i < n; ++i)
+          dst[i] = *eval(
+            f << make_object<T>((*xs)[i]) << make_object<T>((*ys)[i]));
+
+        return result;
+      }
+    };
+
+    /// Fold : (T -> T -> T) -> T -> Array<T> -> T
+    /// Left fold of array.
+    /// \notes Arithmetic BinaryOperator runs SIMD kernel.
+    template <class T>
+    struct ArrayFold
+      : Function<ArrayFold<T>, closure<T, T, T>, T, strict<Array<T>>, T>
+    {
+      typename ArrayFold::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto init = this->template eval_arg<1>();
+        auto xs = this->template eval_arg<2>();
+
+        using Tp = typename T::value_type;
+        Tp acc = *init;
+        if (match_arith_operator<T>(f, 2, [&](auto tag) {
+              using tag_t = decltype(tag);
+              acc = array_fold_kernel<Tp, tag_t::template op>(
+                acc, xs->data(), xs->size());
+            }))
+          return make_object<T>(acc);
+
+        auto r = init;
+        for (auto&& x : *xs)
+          r = eval(f << r << make_object<T>(x));
+
+        return r;
+      }
+    };
+
+    /// Sum : Array<T> -> T
+    template <class T>
+    struct ArraySum : Function<ArraySum<T>, strict<Array<T>>, T>
+    {
+      typename ArraySum::return_type code() const
+      {
+        auto xs = this->template eval_arg<0>();
+        using Tp = typename T::value_type;
+        return make_object<T>(
+          array_fold_kernel<Tp, std::plus>(Tp(), xs->data(), xs->size()));
+      }
+    };
+
+    /// Filter : (T -> Bool) -> Array<T> -> Array<T>
+    /// \notes Partially applied comparison BinaryOperator runs without
+    /// evaluating closure for each element.
+    template <class T>
+    struct ArrayFilter
+      : Function<ArrayFilter<T>, closure<T, Bool>, strict<Array<T>>, Array<T>>
+    {
+      typename ArrayFilter::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto xs = this->template eval_arg<1>();
+
+        using Tp = typename T::value_type;
+        std::vector<Tp> tmp;
+        tmp.reserve(xs->size());
+
+        if (!match_comp_operator<T>(f, 1, [&](auto tag) {
+              using tag_t = decltype(tag);
+              typename tag_t::template op<Tp> op;
+              auto c = bound_arg_value<T>(f);
+              for (auto&& x : *xs)
+                if (op(c, x))
+                  tmp.push_back(x);
+            })) {
+          for (auto&& x : *xs)
+            if (*eval(f << make_object<T>(x)))
+              tmp.push_back(x);
+        }
+
+        return make_object<Array<T>>(tmp.begin(), tmp.end());
+      }
+    };
+
+    /// Scan : (T -> T -> T) -> T -> Array<T> -> Array<T>
+    /// Inclusive left scan. Result has the same length as input.
+    template <class T>
+    struct ArrayScan
+      : Function<ArrayScan<T>, closure<T, T, T>, T, strict<Array<T>>, Array<T>>
+    {
+      typename ArrayScan::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto init = this->template eval_arg<1>();
+        auto xs = this->template eval_arg<2>();
+
+        auto n = xs->size();
+        auto result = make_object<Array<T>>(n);
+        auto dst = result->data();
+
+        using Tp = typename T::value_type;
+        if (match_arith_operator<T>(f, 2, [&](auto tag) {
+              using tag_t = decltype(tag);
+              array_scan_kernel<Tp, tag_t::template op>(
+                *init, xs->data(), dst, n);
+            }))
+          return result;
+
+        auto r = init;
+        for (size_t i = 0; i < n; ++i) {
+          r = eval(f << r << make_object<T>((*xs)[i]));
+          dst[i] = *r;
+        }
+
+        return result;
+      }
+    };
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
+
+TORI_DECL_TYPE(Int8Array)
+TORI_DECL_TYPE(Int16Array)
+TORI_DECL_TYPE(Int32Array)
+TORI_DECL_TYPE(Int64Array)
+
+TORI_DECL_TYPE(UInt8Array)
+TORI_DECL_TYPE(UInt16Array)
+TORI_DECL_TYPE(UInt32Array)
+TORI_DECL_TYPE(UInt64Array)
+
+TORI_DECL_TYPE(FloatArray)
+TORI_DECL_TYPE(DoubleArray)
+
+TORI_DECL_TYPE(BoolArray)
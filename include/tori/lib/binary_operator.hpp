@@ -7,6 +7,7 @@
 
 #if !defined(TORI_NO_LOCAL_INCLUDE)
 #  include "../core.hpp"
+#  include "foldable.hpp"
 #endif
 
 #include <functional>
@@ -15,14 +16,23 @@ namespace TORI_NS::detail {
 
   /// Binary operator function
   template <class T, class R, template <class> class E>
-  struct BinaryOperator : Function<BinaryOperator<T, R, E>, T, T, R>
+  struct BinaryOperator
+    : Function<BinaryOperator<T, R, E>, strict<T>, strict<T>, R>
   {
+    /// Ctor
+    BinaryOperator()
+    {
+      // binary operators are pure
+      [[maybe_unused]] static const bool foldable =
+        (get_foldable_registry().add(get_info_table(this)), true);
+    }
+
     typename BinaryOperator::return_type code() const
     {
       using Tp = typename T::value_type;
       E<Tp> op;
-      auto lhs = this->template eval_arg<0>();
-      auto rhs = this->template eval_arg<1>();
+      auto lhs = this->template eval_arg_ref<0>();
+      auto rhs = this->template eval_arg_ref<1>();
       return make_object<R>(op(*lhs, *rhs));
     }
   };
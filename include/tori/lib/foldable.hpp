@@ -0,0 +1,68 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Foldable closures
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../core.hpp"
+#endif
+
+#include <mutex>
+#include <unordered_set>
+
+namespace TORI_NS::detail {
+
+  /// Set of closure types which can be evaluated by graph optimizer.
+  class foldable_registry
+  {
+  public:
+    /// add closure info table
+    void add(const object_info_table* info)
+    {
+      std::lock_guard lock {m_mtx};
+      m_infos.insert(info);
+    }
+
+    /// find closure info table
+    [[nodiscard]] bool contains(const object_info_table* info) const
+    {
+      std::lock_guard lock {m_mtx};
+      return m_infos.count(info) != 0;
+    }
+
+  private:
+    mutable std::mutex m_mtx;
+    std::unordered_set<const object_info_table*> m_infos;
+  };
+
+  /// global foldable registry
+  [[nodiscard]] inline foldable_registry& get_foldable_registry()
+  {
+    static foldable_registry registry;
+    return registry;
+  }
+
+  namespace interface {
+
+    /// Mark closure type as foldable.
+    /// \notes Foldable closures should be pure: result of code() should only
+    /// depend on values of arguments. Graph optimizer evaluates saturated
+    /// applications of them on constant inputs ahead of time.
+    template <class T>
+    void mark_foldable()
+    {
+      auto tmp = make_object<T>();
+      get_foldable_registry().add(_get_storage(tmp).info_table());
+    }
+
+    /// Is the object a closure marked as foldable?
+    [[nodiscard]] inline bool is_foldable(const object_ptr<const Object>& obj)
+    {
+      return get_foldable_registry().contains(get_info_table(obj.get()));
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
@@ -0,0 +1,494 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Lazy list
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../core.hpp"
+#  include "primitive.hpp"
+#endif
+
+#include <memory>
+#include <vector>
+#include <utility>
+
+namespace TORI_NS::detail {
+
+  // ------------------------------------------
+  // list_object_value
+
+  /// Stage of fused list pipeline
+  struct list_stage
+  {
+    enum class kind : uint8_t
+    {
+      map,
+      filter,
+      take,
+    };
+
+    /// kind of stage
+    kind k;
+    /// closure of map and filter
+    object_ptr<const Object> f;
+  };
+
+  class list_object_value_base;
+
+  /// Access to list objects of specific element type
+  struct list_type_ops
+  {
+    /// get value of list object
+    const list_object_value_base& (*read)(const Object*) noexcept;
+  };
+
+  /// Lazy list.
+  ///
+  /// A list is one of:
+  ///   nil:      empty list (default constructed).
+  ///   cons:     head thunk and tail thunk which evaluates to list.
+  ///   pipeline: source list with stages of Map, Filter and Take which are
+  ///             not applied yet.
+  /// Combinators only append stages to pipeline, and consumers run all stages
+  /// in a single pass over the source without building intermediate lists.
+  ///
+  /// Tail thunks are not memoized: consumers evaluate copy of tail Apply so
+  /// that cells are not linked by caches, and cells which are already
+  /// consumed are released. Traversing a list twice evaluates it twice.
+  class list_object_value_base
+  {
+  public:
+    enum class kind : uint8_t
+    {
+      nil,
+      cons,
+      pipeline,
+    };
+
+    /// Nil
+    list_object_value_base() noexcept = default;
+
+    /// Cons
+    list_object_value_base(
+      object_ptr<const Object> head,
+      object_ptr<const Object> tail) noexcept
+      : m_kind {kind::cons}
+      , m_head {std::move(head)}
+      , m_tail {std::move(tail)}
+    {
+    }
+
+    /// Pipeline
+    list_object_value_base(
+      object_ptr<const Object> source,
+      const list_type_ops* source_ops,
+      std::shared_ptr<const std::vector<list_stage>> stages,
+      std::vector<uint64_t> counts) noexcept
+      : m_kind {kind::pipeline}
+      , m_tail {std::move(source)}
+      , m_ops {source_ops}
+      , m_stages {std::move(stages)}
+      , m_counts {std::move(counts)}
+    {
+    }
+
+    /// is nil?
+    [[nodiscard]] bool is_nil() const noexcept
+    {
+      return m_kind == kind::nil;
+    }
+
+    /// kind of list
+    [[nodiscard]] kind get_kind() const noexcept
+    {
+      return m_kind;
+    }
+
+    /// head thunk of cons
+    [[nodiscard]] const object_ptr<const Object>& head() const noexcept
+    {
+      return m_head;
+    }
+
+    /// tail thunk of cons, or source of pipeline
+    [[nodiscard]] const object_ptr<const Object>& tail() const noexcept
+    {
+      return m_tail;
+    }
+
+    /// element type of pipeline source
+    [[nodiscard]] const list_type_ops* source_ops() const noexcept
+    {
+      return m_ops;
+    }
+
+    /// stages of pipeline
+    [[nodiscard]] const std::shared_ptr<const std::vector<list_stage>>&
+      stages() const noexcept
+    {
+      return m_stages;
+    }
+
+    /// remaining elements of take stages in pipeline
+    [[nodiscard]] const std::vector<uint64_t>& counts() const noexcept
+    {
+      return m_counts;
+    }
+
+    /// visit thunks and closures of stages
+    void visit_children(object_visitor visitor) const
+    {
+      visitor(m_head);
+      visitor(m_tail);
+      if (m_stages)
+        for (auto&& s : *m_stages)
+          visitor(s.f);
+    }
+
+  private:
+    kind m_kind = kind::nil;
+    object_ptr<const Object> m_head;
+    object_ptr<const Object> m_tail;
+    const list_type_ops* m_ops = nullptr;
+    std::shared_ptr<const std::vector<list_stage>> m_stages;
+    std::vector<uint64_t> m_counts;
+  };
+
+  /// Lazy list of T
+  template <class T>
+  class list_object_value : public list_object_value_base
+  {
+  public:
+    using list_object_value_base::list_object_value_base;
+  };
+
+  namespace interface {
+
+    /// Lazy list of T.
+    /// Default constructed list is Nil.
+    /// \notes Use TORI_DECL_TYPE to give name to lists of other types.
+    template <class T>
+    using List = Box<list_object_value<T>>;
+
+    // clang-format off
+
+    using Int8List   = List<Int8>;
+    using Int16List  = List<Int16>;
+    using Int32List  = List<Int32>;
+    using Int64List  = List<Int64>;
+    using UInt8List  = List<UInt8>;
+    using UInt16List = List<UInt16>;
+    using UInt32List = List<UInt32>;
+    using UInt64List = List<UInt64>;
+    using FloatList  = List<Float>;
+    using DoubleList = List<Double>;
+
+    using CharList   = Int8List;
+    using ShortList  = Int16List;
+    using IntList    = Int32List;
+    using LongList   = Int64List;
+
+    using UCharList  = UInt8List;
+    using UShortList = UInt16List;
+    using UIntList   = UInt32List;
+    using ULongList  = UInt64List;
+
+    using BoolList   = List<Bool>;
+    using StringList = List<String>;
+
+    // clang-format on
+
+  } // namespace interface
+
+  template <class T>
+  const list_object_value_base& read_list(const Object* obj) noexcept
+  {
+    return static_cast<const List<T>*>(obj)->value;
+  }
+
+  /// list_type_ops of List<T>
+  template <class T>
+  inline constexpr list_type_ops list_type_ops_v = {&read_list<T>};
+
+  // ------------------------------------------
+  // list_cursor
+
+  /// Evaluate thunk of list.
+  /// Unevaluated Apply is evaluated through copy to avoid caching result.
+  [[nodiscard]] inline object_ptr<const Object>
+    force_list(const object_ptr<const Object>& thunk)
+  {
+    if (auto apply = value_cast_if<Apply>(thunk)) {
+      auto& storage = _get_storage(*apply);
+      if (storage.evaluated())
+        return storage.get_cache();
+      return eval_impl(make_object<Apply>(storage.app(), storage.arg()));
+    }
+    return thunk;
+  }
+
+  /// Pulls elements from list through pipeline stages.
+  /// Holds only current position of source list.
+  class list_cursor
+  {
+  public:
+    /// Ctor
+    /// \param list evaluated list object
+    /// \param ops element type of list
+    list_cursor(object_ptr<const Object> list, const list_type_ops* ops)
+      : m_source {std::move(list)}
+      , m_ops {ops}
+    {
+      splice();
+    }
+
+    /// Get next element thunk.
+    /// \returns null at the end of list.
+    [[nodiscard]] object_ptr<const Object> next()
+    {
+      for (;;) {
+        if (done())
+          return nullptr;
+
+        // tail is evaluated only when next element is requested
+        if (!m_forced) {
+          m_source = force_list(m_source);
+          m_forced = true;
+          splice();
+        }
+
+        auto& cell = m_ops->read(m_source.get());
+
+        if (cell.is_nil())
+          return nullptr;
+
+        auto x = cell.head();
+        m_source = cell.tail();
+        m_forced = false;
+
+        if (run_stages(x))
+          return x;
+      }
+    }
+
+  private:
+    /// Take stage reached its limit?
+    bool done() const noexcept
+    {
+      for (size_t i = 0; i < m_counts.size(); ++i)
+        if ((*m_stages)[i].k == list_stage::kind::take && m_counts[i] == 0)
+          return true;
+      return false;
+    }
+
+    /// Apply stages to element. Returns false when filtered out.
+    bool run_stages(object_ptr<const Object>& x)
+    {
+      if (!m_stages)
+        return true;
+
+      for (size_t i = 0; i < m_stages->size(); ++i) {
+        auto& stage = (*m_stages)[i];
+        switch (stage.k) {
+          case list_stage::kind::map:
+            x = make_object<Apply>(stage.f, x);
+            break;
+          case list_stage::kind::filter:
+            if (!*static_object_cast<const Bool>(
+                  eval_impl(make_object<Apply>(stage.f, x))))
+              return false;
+            break;
+          case list_stage::kind::take:
+            --m_counts[i];
+            break;
+        }
+      }
+      return true;
+    }
+
+    /// Replace source with source of pipeline.
+    /// Stages of the pipeline run before current stages.
+    void splice()
+    {
+      auto& cell = m_ops->read(m_source.get());
+
+      if (cell.get_kind() != list_object_value_base::kind::pipeline)
+        return;
+
+      auto inner = cell.stages();
+      auto counts = cell.counts();
+      auto source = cell.tail();
+
+      if (m_stages && !m_stages->empty()) {
+        auto stages = std::make_shared<std::vector<list_stage>>(*inner);
+        stages->insert(stages->end(), m_stages->begin(), m_stages->end());
+        counts.insert(counts.end(), m_counts.begin(), m_counts.end());
+        inner = std::move(stages);
+      }
+
+      m_ops = cell.source_ops();
+      m_stages = std::move(inner);
+      m_counts = std::move(counts);
+      m_source = force_list(source);
+
+      // source can also be pipeline
+      splice();
+    }
+
+  private:
+    /// current position
+    object_ptr<const Object> m_source;
+    /// is m_source evaluated?
+    bool m_forced = true;
+    /// element type of source
+    const list_type_ops* m_ops;
+    /// stages
+    std::shared_ptr<const std::vector<list_stage>> m_stages;
+    /// remaining elements of take stages
+    std::vector<uint64_t> m_counts;
+  };
+
+  /// Create List<T> object which appends stage to list.
+  template <class T, class U>
+  [[nodiscard]] object_ptr<const List<U>> append_list_stage(
+    const object_ptr<const List<T>>& list,
+    list_stage stage,
+    uint64_t count = 0)
+  {
+    auto& v = *list;
+
+    auto stages = std::make_shared<std::vector<list_stage>>();
+    object_ptr<const Object> source = list;
+    auto ops = &list_type_ops_v<T>;
+    auto counts = std::vector<uint64_t> {};
+
+    if (v.get_kind() == list_object_value_base::kind::pipeline) {
+      *stages = *v.stages();
+      source = v.tail();
+      ops = v.source_ops();
+      counts = v.counts();
+    }
+
+    stages->push_back(std::move(stage));
+    counts.push_back(count);
+
+    return make_object<List<U>>(
+      std::move(source), ops, std::move(stages), std::move(counts));
+  }
+
+  namespace interface {
+
+    /// Cons : T -> List<T> -> List<T>
+    /// \notes Head and tail are not evaluated.
+    template <class T>
+    struct Cons : Function<Cons<T>, T, List<T>, List<T>>
+    {
+      typename Cons::return_type code() const
+      {
+        return make_object<List<T>>(
+          object_ptr<const Object>(this->template arg<0>()),
+          object_ptr<const Object>(this->template arg<1>()));
+      }
+    };
+
+    /// Iterate : (T -> T) -> T -> List<T>
+    /// Infinite list of `x, f x, f (f x), ...`.
+    template <class T>
+    struct Iterate : Function<Iterate<T>, closure<T, T>, T, List<T>>
+    {
+      typename Iterate::return_type code() const
+      {
+        auto f = this->template arg<0>();
+        auto x = this->template eval_arg<1>();
+        auto next = make_object<Apply>(make_object<Iterate>(), f);
+        return make_object<List<T>>(
+          object_ptr<const Object>(x),
+          make_object<Apply>(next, make_object<Apply>(f, x)));
+      }
+    };
+
+    /// Map : (T -> U) -> List<T> -> List<U>
+    /// \notes Elements are not evaluated.
+    template <class T, class U = T>
+    struct Map : Function<Map<T, U>, closure<T, U>, List<T>, List<U>>
+    {
+      typename Map::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto xs = this->template eval_arg<1>();
+        return append_list_stage<T, U>(
+          xs, {list_stage::kind::map, std::move(f)});
+      }
+    };
+
+    /// Filter : (T -> Bool) -> List<T> -> List<T>
+    template <class T>
+    struct Filter : Function<Filter<T>, closure<T, Bool>, List<T>, List<T>>
+    {
+      typename Filter::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto xs = this->template eval_arg<1>();
+        return append_list_stage<T, T>(
+          xs, {list_stage::kind::filter, std::move(f)});
+      }
+    };
+
+    /// Take : Int -> List<T> -> List<T>
+    /// \notes Source is not evaluated after n'th element.
+    template <class T>
+    struct Take : Function<Take<T>, Int, List<T>, List<T>>
+    {
+      typename Take::return_type code() const
+      {
+        auto n = this->template eval_arg<0>();
+        auto xs = this->template eval_arg<1>();
+        return append_list_stage<T, T>(
+          xs, {list_stage::kind::take, nullptr}, *n < 0 ? 0 : *n);
+      }
+    };
+
+    /// FoldL : (A -> T -> A) -> A -> List<T> -> A
+    /// Accumulator is evaluated on each step, so the list is consumed in
+    /// constant memory.
+    template <class T, class A = T>
+    struct FoldL
+      : Function<FoldL<T, A>, closure<A, T, A>, A, List<T>, A>
+    {
+      typename FoldL::return_type code() const
+      {
+        auto f = this->template eval_arg<0>();
+        auto acc = this->template eval_arg<1>();
+        auto xs = this->template eval_arg<2>();
+
+        list_cursor cursor {std::move(xs), &list_type_ops_v<T>};
+
+        while (auto x = cursor.next()) {
+          auto app = make_object<Apply>(make_object<Apply>(f, acc), x);
+          acc = static_object_cast<const A>(eval_impl(app));
+        }
+        return acc;
+      }
+    };
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
+
+TORI_DECL_TYPE(Int8List)
+TORI_DECL_TYPE(Int16List)
+TORI_DECL_TYPE(Int32List)
+TORI_DECL_TYPE(Int64List)
+
+TORI_DECL_TYPE(UInt8List)
+TORI_DECL_TYPE(UInt16List)
+TORI_DECL_TYPE(UInt32List)
+TORI_DECL_TYPE(UInt64List)
+
+TORI_DECL_TYPE(FloatList)
+TORI_DECL_TYPE(DoubleList)
+
+TORI_DECL_TYPE(BoolList)
+TORI_DECL_TYPE(StringList)
@@ -0,0 +1,304 @@
+// Copyright (c) 2018-2019 mocabe(https://github.com/mocabe)
+// This code is licensed under MIT license.
+
+#pragma once
+
+/// \file Graph optimizer
+
+#if !defined(TORI_NO_LOCAL_INCLUDE)
+#  include "../core.hpp"
+#  include "primitive.hpp"
+#  include "identity.hpp"
+#  include "if.hpp"
+#  include "foldable.hpp"
+#endif
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace TORI_NS::detail {
+
+  namespace interface {
+
+    /// Rewrite rule of graph optimizer.
+    /// Called on each Apply node after its inputs are optimized. Returns
+    /// replacement of the node, or null to keep it.
+    /// \notes Replacement should have the same type as the node.
+    using rewrite_rule =
+      std::function<object_ptr<const Object>(const object_ptr<const Apply>&)>;
+
+    /// statistics of optimizer pass
+    struct optimize_pass_stats
+    {
+      /// name of pass
+      std::string name;
+      /// number of rewritten nodes
+      size_t rewrites = 0;
+    };
+
+    /// statistics of optimization
+    struct optimize_stats
+    {
+      /// per-pass statistics in pipeline order
+      std::vector<optimize_pass_stats> passes;
+      /// number of Apply nodes in input graph
+      size_t nodes_before = 0;
+      /// number of Apply nodes in result graph
+      size_t nodes_after = 0;
+    };
+
+  } // namespace interface
+
+  // ------------------------------------------
+  // builtin rules
+
+  /// is unapplied closure of type T?
+  template <class T>
+  [[nodiscard]] bool is_closure_of(const object_ptr<const Object>& obj)
+  {
+    if (get_info_table(obj.get()) != get_closure_info_table<T>())
+      return false;
+    auto c = static_cast<const Closure<>*>(obj.get());
+    return c->arity() == c->n_args();
+  }
+
+  /// Is the object constant input of foldable closure?
+  [[nodiscard]] inline bool
+    is_constant_leaf(const object_ptr<const Object>& obj)
+  {
+    if (value_cast_if<Apply>(obj))
+      return false;
+    return has_value_type(obj) || is_foldable(obj);
+  }
+
+  /// Evaluate saturated application of foldable closure on constants.
+  [[nodiscard]] inline object_ptr<const Object>
+    fold_constant(const object_ptr<const Apply>& apply)
+  {
+    uint64_t n = 0;
+    object_ptr<const Object> head = apply;
+
+    while (auto a = value_cast_if<Apply>(head)) {
+      auto& storage = _get_storage(*a);
+      if (storage.evaluated() || !is_constant_leaf(storage.arg()))
+        return nullptr;
+      head = storage.app();
+      ++n;
+    }
+
+    if (!has_arrow_type(head) || !is_foldable(head))
+      return nullptr;
+
+    if (static_cast<const Closure<>*>(head.get())->arity() != n)
+      return nullptr;
+
+    // exceptions are left to runtime
+    try {
+      return eval_impl(copy_apply_graph(apply));
+    } catch (const result_error::exception_result&) {
+      return nullptr;
+    }
+  }
+
+  /// Replace `If << cond << t << e` with branch when `cond` is constant.
+  [[nodiscard]] inline object_ptr<const Object>
+    prune_if(const object_ptr<const Apply>& apply)
+  {
+    auto& s3 = _get_storage(*apply);
+
+    auto a2 = value_cast_if<Apply>(s3.app());
+    if (!a2 || _get_storage(*a2).evaluated())
+      return nullptr;
+    auto& s2 = _get_storage(*a2);
+
+    auto a1 = value_cast_if<Apply>(s2.app());
+    if (!a1 || _get_storage(*a1).evaluated())
+      return nullptr;
+    auto& s1 = _get_storage(*a1);
+
+    if (!is_closure_of<If>(s1.app()))
+      return nullptr;
+
+    auto cond = value_cast_if<Bool>(s1.arg());
+    if (!cond)
+      return nullptr;
+
+    return *cond ? s2.arg() : s3.arg();
+  }
+
+  /// Replace `Identity << x` with `x`.
+  [[nodiscard]] inline object_ptr<const Object>
+    eliminate_identity(const object_ptr<const Apply>& apply)
+  {
+    auto& storage = _get_storage(*apply);
+
+    if (!is_closure_of<Identity>(storage.app()))
+      return nullptr;
+
+    return storage.arg();
+  }
+
+  // ------------------------------------------
+  // graph_optimizer
+
+  namespace interface {
+
+    /// Pass pipeline which rewrites Apply graphs before evaluation.
+    ///
+    /// The graph is rebuilt bottom-up and each Apply node is passed to rules
+    /// in pipeline order until one of them rewrites it. Input graph is not
+    /// modified and shared subgraphs stay shared in the result.
+    /// Default pipeline:
+    ///   dead_subgraph_removal: replace evaluated Apply with its cache and
+    ///                          drop nodes unreachable from result.
+    ///   constant_folding:      evaluate foldable closures on constants.
+    ///   if_pruning:            select branch of If on constant condition.
+    ///   identity_elimination:  remove Identity applications.
+    /// \notes Do not evaluate the input graph while optimizing it.
+    class graph_optimizer
+    {
+    public:
+      /// Ctor
+      graph_optimizer()
+      {
+        add_rule("constant_folding", fold_constant);
+        add_rule("if_pruning", prune_if);
+        add_rule("identity_elimination", eliminate_identity);
+      }
+
+      /// Add rule at the end of pipeline.
+      void add_rule(std::string name, rewrite_rule rule)
+      {
+        m_passes.push_back({std::move(name), std::move(rule)});
+      }
+
+      /// optimize graph
+      [[nodiscard]] object_ptr<const Object>
+        optimize(const object_ptr<const Object>& graph)
+      {
+        m_stats = {};
+        m_stats.passes.push_back({"dead_subgraph_removal", 0});
+        for (auto&& p : m_passes)
+          m_stats.passes.push_back({p.name, 0});
+
+        m_stats.nodes_before = count_nodes(graph);
+        auto result = rewrite(graph);
+        m_stats.nodes_after = count_nodes(result);
+
+        m_memo.clear();
+        return result;
+      }
+
+      /// statistics of last optimize()
+      [[nodiscard]] const optimize_stats& stats() const noexcept
+      {
+        return m_stats;
+      }
+
+    private:
+      /// rewrite subgraph
+      object_ptr<const Object> rewrite(const object_ptr<const Object>& obj)
+      {
+        auto apply = value_cast_if<Apply>(obj);
+
+        if (!apply)
+          return obj;
+
+        if (auto it = m_memo.find(obj.get()); it != m_memo.end())
+          return it->second.result;
+
+        auto& storage = _get_storage(*apply);
+
+        object_ptr<const Object> result;
+
+        if (storage.evaluated()) {
+          // inputs of evaluated node are dead
+          ++m_stats.passes[0].rewrites;
+          result = storage.get_cache();
+        } else {
+          auto app = rewrite(storage.app());
+          auto arg = rewrite(storage.arg());
+
+          object_ptr<const Apply> node = apply;
+          if (app != storage.app() || arg != storage.arg())
+            node = make_object<Apply>(std::move(app), std::move(arg));
+
+          result = node;
+
+          for (size_t i = 0; i < m_passes.size(); ++i) {
+            if (auto r = m_passes[i].rule(node)) {
+              ++m_stats.passes[i + 1].rewrites;
+              result = rewrite(r);
+              break;
+            }
+          }
+        }
+
+        m_memo.emplace(obj.get(), memo_entry {obj, result});
+        m_memo.emplace(result.get(), memo_entry {result, result});
+        return result;
+      }
+
+      /// count Apply nodes
+      [[nodiscard]] static size_t
+        count_nodes(const object_ptr<const Object>& obj)
+      {
+        std::unordered_set<const Object*> visited;
+        std::vector<object_ptr<const Object>> stack = {obj};
+
+        while (!stack.empty()) {
+          auto o = std::move(stack.back());
+          stack.pop_back();
+
+          auto apply = value_cast_if<Apply>(o);
+          if (!apply || !visited.insert(o.get()).second)
+            continue;
+
+          auto& storage = _get_storage(*apply);
+          if (storage.evaluated())
+            continue;
+
+          stack.push_back(storage.app());
+          stack.push_back(storage.arg());
+        }
+        return visited.size();
+      }
+
+    private:
+      /// rule in pipeline
+      struct pass
+      {
+        std::string name;
+        rewrite_rule rule;
+      };
+
+      /// rewritten node
+      struct memo_entry
+      {
+        /// keeps address of key alive
+        object_ptr<const Object> source;
+        object_ptr<const Object> result;
+      };
+
+      /// rules
+      std::vector<pass> m_passes;
+      /// stats
+      optimize_stats m_stats;
+      /// rewritten nodes
+      std::unordered_map<const Object*, memo_entry> m_memo;
+    };
+
+    /// Optimize graph with default pipeline.
+    [[nodiscard]] inline object_ptr<const Object>
+      optimize(const object_ptr<const Object>& graph)
+    {
+      graph_optimizer optimizer;
+      return optimizer.optimize(graph);
+    }
+
+  } // namespace interface
+
+} // namespace TORI_NS::detail
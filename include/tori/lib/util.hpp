@@ -11,6 +11,8 @@
 #include <string>
 #include <variant>
 #include <algorithm>
+#include <ostream>
+#include <iomanip>
 
 namespace TORI_NS::detail {
 
@@ -54,6 +56,109 @@ namespace TORI_NS::detail {
       return to_string_impl<MaxDepth>(type, 1);
     }
 
+    /// Print profile report, sorted by exclusive time.
+    inline void dump_profile(std::ostream& os, profile_snapshot snapshot)
+    {
+      auto& rs = snapshot.records;
+      std::sort(rs.begin(), rs.end(), [](auto& lhs, auto& rhs) {
+        return lhs.counters.exclusive_ns > rhs.counters.exclusive_ns;
+      });
+
+      os << "cache hits: " << snapshot.cache_hits
+         << ", cache misses: " << snapshot.cache_misses << "\n";
+
+      os << std::setw(12) << "calls" << std::setw(14) << "incl(us)"
+         << std::setw(14) << "excl(us)" << std::setw(10) << "allocs"
+         << std::setw(10) << "excepts" << std::setw(10) << "misses"
+         << "  type\n";
+
+      for (auto&& r : rs) {
+        auto& c = r.counters;
+        os << std::setw(12) << c.calls                   //
+           << std::setw(14) << c.inclusive_ns / 1000     //
+           << std::setw(14) << c.exclusive_ns / 1000     //
+           << std::setw(10) << c.allocations             //
+           << std::setw(10) << c.exceptions              //
+           << std::setw(10) << c.cache_misses            //
+           << "  " << to_string(r.type) << "\n";
+      }
+    }
+
+    /// Print current profile report.
+    inline void dump_profile(std::ostream& os)
+    {
+      dump_profile(os, get_profile());
+    }
+
+    /// Print heap report, sorted by live bytes.
+    inline void dump_heap_stats(std::ostream& os, heap_snapshot snapshot)
+    {
+      auto& rs = snapshot.records;
+      std::sort(rs.begin(), rs.end(), [](auto& lhs, auto& rhs) {
+        return lhs.live_bytes > rhs.live_bytes;
+      });
+
+      os << "live objects: " << snapshot.live_objects
+         << ", live bytes: " << snapshot.live_bytes << "\n";
+
+      os << std::setw(12) << "objects" << std::setw(14) << "bytes"
+         << "  type\n";
+
+      for (auto&& r : rs) {
+        os << std::setw(12) << r.live_objects //
+           << std::setw(14) << r.live_bytes   //
+           << "  " << to_string(r.type) << "\n";
+      }
+    }
+
+    /// Print current heap report.
+    inline void dump_heap_stats(std::ostream& os)
+    {
+      dump_heap_stats(os, get_heap_stats());
+    }
+
+    /// Write events in Chrome trace event format (JSON).
+    /// Output can be loaded from chrome://tracing or Perfetto UI.
+    inline void
+      dump_chrome_trace(std::ostream& os, const std::vector<trace_event>& events)
+    {
+      auto escape = [](const std::string& str) {
+        std::string ret;
+        for (auto&& c : str) {
+          if (c == '"' || c == '\\')
+            ret += '\\';
+          ret += c;
+        }
+        return ret;
+      };
+
+      uint64_t base = events.empty() ? 0 : events.front().timestamp;
+      for (auto&& e : events) base = std::min(base, e.timestamp);
+
+      os << "{\"traceEvents\":[";
+      for (size_t i = 0; i < events.size(); ++i) {
+        auto& e  = events[i];
+        auto ts  = e.timestamp - base;
+        auto cat = e.kind == trace_kind::eval ? "eval" : "code";
+        os << (i == 0 ? "\n" : ",\n")                              //
+           << "{\"name\":\""                                        //
+           << (e.type ? escape(to_string(e.type)) : std::string(cat)) //
+           << "\",\"cat\":\"" << cat                                 //
+           << "\",\"ph\":\""                                         //
+           << (e.phase == trace_phase::begin ? "B" : "E")             //
+           << "\",\"ts\":" << ts / 1000 << "." << std::setw(3)        //
+           << std::setfill('0') << ts % 1000 << std::setfill(' ')     //
+           << ",\"pid\":1,\"tid\":" << e.thread << "}";
+      }
+      os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    /// Write recorded events in Chrome trace event format (JSON).
+    inline void dump_chrome_trace(std::ostream& os)
+    {
+      dump_chrome_trace(os, get_trace());
+    }
+
   } // namespace interface
 
 } // namespace TORI_NS::detail
\ No newline at end of file
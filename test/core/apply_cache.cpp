@@ -0,0 +1,147 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace tori;
+
+namespace {
+
+  int make_count = 0;
+
+  struct MakeArray : Function<MakeArray, Int, IntArray>
+  {
+    return_type code() const
+    {
+      ++make_count;
+      return new IntArray(size_t(*eval_arg<0>()), 1);
+    }
+  };
+
+  auto make_node()
+  {
+    return make_object<MakeArray>() << make_object<Int>(100);
+  }
+
+  constexpr size_t array_size = sizeof(IntArray) + 100 * sizeof(int);
+  // result and inputs of make_node()
+  constexpr size_t entry_size = array_size + sizeof(MakeArray) + sizeof(Int);
+
+} // namespace
+
+TEST_CASE("object_size")
+{
+  REQUIRE(object_size(make_object<Int>(42)) == sizeof(Int));
+  REQUIRE(
+    object_size(make_object<IntArray>(size_t(10))) ==
+    sizeof(IntArray) + 10 * sizeof(int));
+  REQUIRE(
+    object_size(make_object<DoubleArray>()) == sizeof(DoubleArray));
+  REQUIRE(object_size(make_object<String>("abc")) == sizeof(String) + 4);
+  REQUIRE(object_size(nullptr) == 0);
+}
+
+TEST_CASE("apply cache eviction")
+{
+  set_apply_cache_budget(0);
+
+  SECTION("disabled")
+  {
+    auto a = make_node();
+    REQUIRE(eval(a)->size() == 100);
+    REQUIRE(get_apply_cache_stats().tracked == 0);
+  }
+
+  SECTION("budget")
+  {
+    set_apply_cache_budget(2 * entry_size);
+    REQUIRE(get_apply_cache_budget() == 2 * entry_size);
+
+    auto before = get_apply_cache_stats();
+
+    std::vector<decltype(make_node())> nodes;
+    for (int i = 0; i < 4; ++i) {
+      nodes.push_back(make_node());
+      REQUIRE(eval(nodes.back())->size() == 100);
+    }
+
+    auto stats = get_apply_cache_stats();
+    REQUIRE(stats.tracked == 4);
+    REQUIRE(stats.bytes <= 2 * entry_size);
+    REQUIRE(stats.evictions - before.evictions == 2);
+
+    // recompute evicted nodes
+    make_count = 0;
+    for (auto&& n : nodes)
+      REQUIRE((*eval(n))[99] == 1);
+    REQUIRE(make_count >= 2);
+
+    stats = get_apply_cache_stats();
+    REQUIRE(stats.recomputations - before.recomputations == size_t(make_count));
+    REQUIRE(stats.bytes <= 2 * entry_size);
+  }
+
+  SECTION("second chance")
+  {
+    set_apply_cache_budget(2 * entry_size);
+
+    auto a = make_node();
+    auto b = make_node();
+    auto c = make_node();
+
+    (void)eval(a);
+    (void)eval(b);
+    // cache hit sets reference bit
+    (void)eval(a);
+    // evicts b
+    (void)eval(c);
+
+    make_count = 0;
+    (void)eval(a);
+    REQUIRE(make_count == 0);
+    (void)eval(b);
+    REQUIRE(make_count == 1);
+  }
+
+  SECTION("dead nodes")
+  {
+    set_apply_cache_budget(2 * entry_size);
+
+    auto before = get_apply_cache_stats();
+    for (int i = 0; i < 4; ++i)
+      (void)eval(make_node());
+
+    // unreachable nodes are dropped without eviction
+    auto stats = get_apply_cache_stats();
+    REQUIRE(stats.evictions == before.evictions);
+    REQUIRE(stats.tracked <= 2);
+  }
+
+  SECTION("unreachable")
+  {
+    set_apply_cache_budget(1 << 30);
+
+    auto before = get_apply_cache_stats();
+    for (int i = 0; i < 100; ++i)
+      (void)eval(make_node());
+
+    // dropped even when under budget
+    auto stats = get_apply_cache_stats();
+    REQUIRE(stats.evictions == before.evictions);
+    REQUIRE(stats.tracked <= 2);
+    REQUIRE(stats.bytes <= 2 * entry_size);
+
+    auto a = make_node();
+    (void)eval(a);
+    a = nullptr;
+    set_apply_cache_budget(1 << 30);
+    REQUIRE(get_apply_cache_stats().tracked == 0);
+    REQUIRE(get_apply_cache_stats().bytes == 0);
+  }
+
+  set_apply_cache_budget(0);
+  REQUIRE(get_apply_cache_stats().tracked == 0);
+  REQUIRE(get_apply_cache_stats().bytes == 0);
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+#include <numeric>
+
+using namespace tori;
+
+namespace {
+
+  struct Twice : Function<Twice, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg<0>() * 2);
+    }
+  };
+
+  struct Max : Function<Max, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(std::max(*eval_arg<0>(), *eval_arg<1>()));
+    }
+  };
+
+  struct IsOdd : Function<IsOdd, Int, Bool>
+  {
+    return_type code() const
+    {
+      return new Bool(*eval_arg<0>() % 2 != 0);
+    }
+  };
+
+  template <class T>
+  object_ptr<Array<T>> iota(size_t n)
+  {
+    auto r = make_object<Array<T>>(n);
+    std::iota(r->begin(), r->end(), typename T::value_type(1));
+    return r;
+  }
+
+} // namespace
+
+TEST_CASE("array_object_value")
+{
+  std::vector<int> v = {1, 2, 3};
+  auto a = make_object<IntArray>(v.begin(), v.end());
+  REQUIRE(a->size() == 3);
+  REQUIRE((*a)[2] == 3);
+  REQUIRE(reinterpret_cast<uintptr_t>(a->data()) % 32 == 0);
+
+  auto b = clone(a);
+  REQUIRE(value_cast<IntArray>(b)->data() != a->data());
+  REQUIRE(value_cast<IntArray>(b)->size() == 3);
+
+  REQUIRE(make_object<DoubleArray>()->empty());
+  REQUIRE(make_object<DoubleArray>(size_t(4), 1.5)->data()[3] == 1.5);
+
+  REQUIRE(same_type(object_type<IntArray>(), object_type<Array<Int>>()));
+  REQUIRE(!same_type(object_type<IntArray>(), object_type<FloatArray>()));
+}
+
+TEST_CASE("Array closures")
+{
+  // length not multiple of vector width
+  constexpr size_t n = 37;
+
+  auto xs = iota<Int>(n);
+  auto fs = iota<Float>(n);
+
+  SECTION("ArrayMap")
+  {
+    // SIMD
+    auto map = make_object<ArrayMap<Int>>();
+    auto r = eval(map << (make_object<MinusInt>() << new Int(100)) << xs);
+    REQUIRE(r->size() == n);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*r)[i] == 100 - (*xs)[i]);
+
+    auto mul = make_object<MultiplesFloat>() << new Float(0.5f);
+    auto rf = eval(make_object<ArrayMap<Float>>() << mul << fs);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*rf)[i] == 0.5f * (*fs)[i]);
+
+    // per element
+    auto r2 = eval(map << make_object<Twice>() << xs);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*r2)[i] == 2 * (*xs)[i]);
+
+    // change element type
+    auto odd = make_object<ArrayMap<Int, Bool>>();
+    auto r3 = eval(odd << make_object<IsOdd>() << xs);
+    REQUIRE((*r3)[0]);
+    REQUIRE(!(*r3)[1]);
+  }
+
+  SECTION("ArrayZipWith")
+  {
+    auto zip = make_object<ArrayZipWith<Int>>();
+    auto r = eval(zip << make_object<PlusInt>() << xs << iota<Int>(n + 3));
+    REQUIRE(r->size() == n);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*r)[i] == 2 * (*xs)[i]);
+
+    auto r2 = eval(zip << make_object<Max>() << xs << iota<Int>(5));
+    REQUIRE(r2->size() == 5);
+    REQUIRE((*r2)[4] == 5);
+  }
+
+  SECTION("ArrayFold")
+  {
+    auto fold = make_object<ArrayFold<Int>>();
+    auto sum = n * (n + 1) / 2;
+    auto plus = make_object<PlusInt>();
+    auto minus = make_object<MinusInt>();
+    REQUIRE(*eval(fold << plus << new Int(10) << xs) == int(sum + 10));
+    // not associative
+    REQUIRE(*eval(fold << minus << new Int(0) << xs) == -int(sum));
+    REQUIRE(*eval(fold << make_object<Max>() << new Int(0) << xs) == int(n));
+
+    auto isum = make_object<ArraySum<Int>>();
+    auto dsum = make_object<ArraySum<Double>>();
+    REQUIRE(*eval(isum << xs) == int(sum));
+    REQUIRE(*eval(isum << make_object<IntArray>()) == 0);
+    REQUIRE(*eval(dsum << iota<Double>(n)) == double(sum));
+  }
+
+  SECTION("ArrayFilter")
+  {
+    auto filter = make_object<ArrayFilter<Int>>();
+    // 30 < x
+    auto r = eval(filter << (make_object<LessInt>() << new Int(30)) << xs);
+    REQUIRE(r->size() == n - 30);
+    REQUIRE((*r)[0] == 31);
+
+    auto r2 = eval(filter << make_object<IsOdd>() << xs);
+    REQUIRE(r2->size() == (n + 1) / 2);
+    REQUIRE((*r2)[1] == 3);
+  }
+
+  SECTION("ArrayScan")
+  {
+    auto scan = make_object<ArrayScan<Int>>();
+    auto r = eval(scan << make_object<PlusInt>() << new Int(0) << xs);
+    auto r2 = eval(scan << make_object<Max>() << new Int(3) << xs);
+    REQUIRE(r->size() == n);
+    for (size_t i = 0; i < n; ++i) {
+      REQUIRE((*r)[i] == int((i + 1) * (i + 2) / 2));
+      REQUIRE((*r2)[i] == std::max(3, int(i + 1)));
+    }
+  }
+}
+
+TEST_CASE("Array SIMD levels")
+{
+  constexpr size_t n = 37;
+
+  auto xs = iota<Int>(n);
+  auto ls = iota<Long>(n);
+  auto ds = iota<Double>(n);
+
+  auto map = make_object<ArrayMap<Int>>();
+  auto lzip = make_object<ArrayZipWith<Long>>();
+  auto dmap = make_object<ArrayMap<Double>>();
+  auto isum = make_object<ArraySum<Int>>();
+  auto dsum = make_object<ArraySum<Double>>();
+
+  auto levels = {
+    simd_level::none, simd_level::sse2, simd_level::avx, simd_level::avx2};
+
+  for (auto level : levels) {
+    set_simd_level(level);
+    REQUIRE(get_simd_level() <= level);
+
+    auto r = eval(map << (make_object<MultiplesInt>() << new Int(3)) << xs);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*r)[i] == 3 * (*xs)[i]);
+
+    auto rl = eval(lzip << make_object<MinusLong>() << ls << ls);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*rl)[i] == 0);
+
+    auto inv = make_object<DividesDouble>() << new Double(1.0);
+    auto rd = eval(dmap << inv << ds);
+    for (size_t i = 0; i < n; ++i)
+      REQUIRE((*rd)[i] == 1 / (*ds)[i]);
+
+    REQUIRE(*eval(isum << xs) == int(n * (n + 1) / 2));
+    REQUIRE(*eval(dsum << ds) == double(n * (n + 1) / 2));
+
+    // value_type::compare
+    REQUIRE(same_type(object_type<IntArray>(), object_type<Array<Int>>()));
+    REQUIRE(!same_type(object_type<IntArray>(), object_type<UIntArray>()));
+  }
+
+  set_simd_level(simd_level::avx2);
+}
@@ -0,0 +1,44 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace tori;
+using namespace tori::detail;
+
+TEST_CASE("atomic_spinlock")
+{
+  SECTION("try_lock")
+  {
+    atomic_spinlock<uint8_t> lock;
+    REQUIRE(lock.try_lock());
+    REQUIRE(!lock.try_lock());
+    lock.unlock();
+    REQUIRE(lock.try_lock());
+    lock.unlock();
+  }
+
+  SECTION("contention")
+  {
+    auto obj = make_object<Int>(0);
+    auto& lock = obj.get()->spinlock;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([&] {
+        for (int j = 0; j < 10000; ++j) {
+          std::lock_guard guard {lock};
+          ++*const_cast<int*>(obj.value());
+        }
+      });
+    }
+    for (auto&& t : threads) t.join();
+
+    REQUIRE(*obj == 80000);
+    REQUIRE(lock.try_lock());
+    lock.unlock();
+  }
+}
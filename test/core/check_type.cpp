@@ -0,0 +1,71 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+using namespace tori;
+using namespace tori::detail;
+
+namespace {
+
+  template <class T>
+  object_ptr<const Type> hybrid(const object_ptr<T>& obj)
+  {
+    return type_of_hybrid(obj, get_term<T>());
+  }
+
+} // namespace
+
+TEST_CASE("check_type")
+{
+  auto add = make_object<Add>();
+  auto i = make_object<Int>(1);
+
+  SECTION("static")
+  {
+    auto app = add << (add << i << i) << i;
+    REQUIRE_NOTHROW(check_type<Int>(app));
+    REQUIRE_NOTHROW(check_type<closure<Int, Int>>(add << i));
+    // static type object is returned without runtime inference
+    REQUIRE(hybrid(app).get() == object_type<Int>().get());
+    REQUIRE_THROWS_AS(check_type<Double>(app), type_error::bad_type_check);
+  }
+
+  SECTION("dynamic")
+  {
+    object_ptr<const Object> d = add << i;
+    auto app = add << (d << i) << i;
+    REQUIRE(same_type(hybrid(app), object_type<Int>()));
+    REQUIRE_NOTHROW(check_type<Int>(app));
+    REQUIRE_NOTHROW(check_type<Int>(object_ptr<const Object>(app)));
+    REQUIRE_THROWS_AS(check_type<Double>(app), type_error::bad_type_check);
+
+    object_ptr<const Object> bad = make_object<Double>(1.0);
+    REQUIRE_THROWS(check_type<Int>(add << bad << i));
+  }
+
+  SECTION("evaluated")
+  {
+    object_ptr<const Object> d = add << i << i;
+    auto app = add << d << i;
+    (void)eval(d);
+    REQUIRE(same_type(hybrid(app), object_type<Int>()));
+  }
+}
+
+TEST_CASE("checked_eval")
+{
+  auto add = make_object<Add>();
+  auto i = make_object<Int>(1);
+
+  object_ptr<const Object> d = add << i;
+  auto r = checked_eval<Int>(add << (d << i) << i);
+  static_assert(std::is_same_v<decltype(r), object_ptr<const Int>>);
+  REQUIRE(*r == 3);
+
+  REQUIRE_THROWS_AS(
+    checked_eval<Double>(object_ptr<const Object>(add << i << i)),
+    type_error::bad_type_check);
+}
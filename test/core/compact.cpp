@@ -0,0 +1,140 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+using namespace tori;
+
+TEST_CASE("compact")
+{
+  SECTION("empty")
+  {
+    compacted_graph g;
+    REQUIRE(!g.root());
+    REQUIRE(g.object_count() == 0);
+    REQUIRE(!compact(object_ptr<const Object>()).root());
+  }
+
+  SECTION("layout")
+  {
+    auto plus = make_object<PlusInt>();
+    auto tree = build_sum_tree(plus, 64);
+    auto g = compact(tree);
+
+    // 126 Apply, 64 Int and PlusInt
+    REQUIRE(g.object_count() == 191);
+    REQUIRE(g.root() != tree);
+    REQUIRE(!g.root().is_static());
+    REQUIRE(g.root().use_count() == 1);
+    REQUIRE(g.owns(g.root()));
+    REQUIRE(!g.owns(tree));
+    REQUIRE(plus.use_count() == 1 + 63);
+
+    // depth-first: root, then closure of root
+    auto root = value_cast<Apply>(g.root());
+    auto app = _get_storage(*root).app();
+    REQUIRE(g.owns(app));
+    REQUIRE(
+      reinterpret_cast<const char*>(app.get()) -
+        reinterpret_cast<const char*>(root.get()) ==
+      32);
+
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 64 * 65 / 2);
+    REQUIRE(*value_cast<Int>(eval(tree)) == 64 * 65 / 2);
+  }
+
+  SECTION("sharing")
+  {
+    auto x = make_object<Int>(1);
+    auto src = make_object<PlusInt>() << x << x;
+    auto g = compact(src);
+    REQUIRE(g.object_count() == 4);
+    REQUIRE(x.use_count() == 3);
+    src = nullptr;
+    REQUIRE(x.use_count() == 1);
+
+    auto root = value_cast<Apply>(g.root());
+    auto arg = _get_storage(*root).arg();
+    auto app = value_cast<Apply>(_get_storage(*root).app());
+    REQUIRE(arg == _get_storage(*app).arg());
+    REQUIRE(arg != x);
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 2);
+  }
+
+  SECTION("static")
+  {
+    auto plus = static_closure<PlusInt>();
+    auto g = compact(build_sum_tree(plus, 8));
+    REQUIRE(g.object_count() == 14 + 8);
+
+    auto n = g.root();
+    while (auto a = value_cast_if<Apply>(n))
+      n = _get_storage(*a).app();
+    REQUIRE(n == plus);
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 8 * 9 / 2);
+  }
+
+  SECTION("release")
+  {
+    weak_object_ptr<const Object> result;
+    {
+      auto g = compact(build_sum_tree(make_object<PlusInt>(), 16));
+      auto r = eval(g.root());
+      result = r;
+      REQUIRE(*value_cast<Int>(r) == 16 * 17 / 2);
+    }
+    // caches stored in graph are released with it
+    REQUIRE(result.expired());
+  }
+
+  SECTION("lifetime")
+  {
+    object_ptr<const Object> root;
+    object_ptr<const Object> leaf;
+    weak_object_ptr<const Object> weak;
+    {
+      auto g = compact(build_sum_tree(make_object<PlusInt>(), 4));
+      root = g.root();
+      REQUIRE(root.use_count() == 2);
+
+      auto n = value_cast<Apply>(root);
+      leaf = _get_storage(*n).arg();
+      weak = leaf;
+      REQUIRE(g.owns(leaf));
+    }
+    // references keep copies alive
+    REQUIRE(*value_cast<Int>(eval(root)) == 10);
+    REQUIRE(*value_cast<Int>(eval(leaf)) == 3 + 4);
+    REQUIRE(weak.lock() == leaf);
+
+    root = nullptr;
+    REQUIRE(leaf.use_count() == 1);
+    leaf = nullptr;
+    REQUIRE(weak.expired());
+    REQUIRE(!weak.lock());
+  }
+
+  SECTION("recompact")
+  {
+    auto g = compact(build_sum_tree(make_object<PlusInt>(), 16));
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 16 * 17 / 2);
+
+    // edit evaluated root
+    weak_object_ptr<const Object> arg;
+    {
+      auto root = value_cast<Apply>(g.root());
+      _get_storage(*root).reset(
+        make_object<PlusInt>() << make_object<Int>(1), make_object<Int>(2));
+      arg = _get_storage(*root).arg();
+      REQUIRE(!g.owns(_get_storage(*root).arg()));
+    }
+
+    g = compact(g);
+    REQUIRE(g.object_count() == 5);
+    REQUIRE(g.owns(g.root()));
+    REQUIRE(arg.expired());
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 3);
+  }
+}
\ No newline at end of file
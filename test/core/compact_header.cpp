@@ -0,0 +1,62 @@
+#define TORI_COMPACT_HEADER
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace tori;
+using namespace tori::detail;
+
+TEST_CASE("compact header layout")
+{
+  static_assert(sizeof(Object) == 8);
+  static_assert(sizeof(Int) == 16);
+  static_assert(sizeof(Apply) == 24);
+
+  auto i = make_object<Int>(42);
+  REQUIRE(reinterpret_cast<uintptr_t>(i.get()) % 8 == 0);
+  REQUIRE(get_info_table(i.get()) == &Int::info_table_initializer::info_table);
+  REQUIRE(get_info_table(i.get()) == _get_storage(i).info_table());
+  REQUIRE(i.use_count() == 1);
+
+  auto c = clone(i);
+  REQUIRE(c.get()->info_index == i.get()->info_index);
+  REQUIRE(get_info_table(make_object<Int>().get()) == get_info_table(i.get()));
+  auto d = make_object<Double>();
+  REQUIRE(get_info_table(i.get()) != get_info_table(d.get()));
+
+  // static objects
+  auto t = object_type<Int>();
+  REQUIRE(t.is_static());
+  REQUIRE(get_type(t) == object_type<Type>());
+}
+
+TEST_CASE("compact header eval")
+{
+  auto plus = make_object<PlusInt>();
+  auto x = make_object<Int>(1);
+  auto g = plus << (plus << x << x) << new Int(3);
+
+  REQUIRE(same_type(type_of(g), object_type<Int>()));
+  REQUIRE(*eval(g) == 5);
+  REQUIRE(has_arrow_type(plus));
+  REQUIRE(*value_cast<Int>(object_ptr<const Object>(x)) == 1);
+  REQUIRE_THROWS_AS(
+    value_cast<Double>(object_ptr<const Object>(x)), bad_value_cast);
+
+  auto _if = make_object<If>();
+  REQUIRE(*eval(_if << new Bool(false) << x << new Int(2)) == 2);
+}
+
+TEST_CASE("compact header spinlock")
+{
+  auto i = make_object<Int>();
+  auto& lock = get_object_spinlock(i.get());
+  REQUIRE(&lock == &get_object_spinlock(i.get()));
+  lock.lock();
+  REQUIRE(!lock.try_lock());
+  lock.unlock();
+  REQUIRE(lock.try_lock());
+  lock.unlock();
+}
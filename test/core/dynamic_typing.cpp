@@ -4,6 +4,8 @@
 #include <catch2/catch.hpp>
 
 #include <iostream>
+#include <set>
+#include <thread>
 
 using namespace tori::detail;
 
@@ -447,4 +449,133 @@ TEST_CASE("copy_type")
     auto cpy = copy_type(tp);
     REQUIRE(same_type(tp, cpy));
   }
+}
+TEST_CASE("value_type_id")
+{
+  auto& i = get<value_type>(*object_type<Int>());
+  auto& d = get<value_type>(*object_type<Double>());
+
+  static_assert(value_type_id<Int>() != value_type_id<Double>());
+  REQUIRE(i.id == value_type_id<Int>());
+  REQUIRE(i.id == value_type_id(i.c_str()));
+  REQUIRE(i.id != d.id);
+
+  // runtime value types share ID space
+  auto t = intern_value_type(i.c_str());
+  REQUIRE(t.id == i.id);
+  REQUIRE(same_type(make_object<Type>(t), object_type<Int>()));
+  REQUIRE(intern_value_type("tori::test::Unknown").name ==
+          intern_value_type("tori::test::Unknown").name);
+
+  // colliding IDs are told apart by name
+  auto collision = value_type {d.name, i.id};
+  REQUIRE(!value_type::compare(collision, i));
+  REQUIRE(!same_type(make_object<Type>(collision), object_type<Int>()));
+  REQUIRE(value_type::compare(t, i));
+
+  // name compare is dispatched by SIMD level
+  auto buffer = *i.name;
+  auto copy = value_type {&buffer, i.id};
+  simd_level levels[] = {
+    simd_level::none, simd_level::sse2, simd_level::avx, simd_level::avx2};
+  for (auto level : levels) {
+    set_simd_level(level);
+    REQUIRE(value_type::compare(copy, i));
+    REQUIRE(!value_type::compare(collision, i));
+  }
+  set_simd_level(simd_level::avx2);
+}
+
+TEST_CASE("hash_type")
+{
+  struct F : Function<F, Int, Double>
+  {
+    return_type code() const
+    {
+      return new Double(static_cast<double>(*eval_arg<0>()));
+    }
+  };
+
+  auto i = object_type<Int>();
+  auto d = object_type<Double>();
+  auto f = object_type<F>();
+
+  REQUIRE(hash_type(i) == hash_type(copy_type(i)));
+  REQUIRE(hash_type(f) == hash_type(copy_type(f)));
+  REQUIRE(hash_type(f) == hash_type(object_type<closure<Int, Double>>()));
+  REQUIRE(hash_type(i) != hash_type(d));
+  REQUIRE(hash_type(f) != hash_type(object_type<closure<Double, Int>>()));
+  REQUIRE(hash_type(nullptr) == 0);
+
+  auto v = genvar();
+  REQUIRE(hash_type(v) == hash_type(copy_type(v)));
+  REQUIRE(hash_type(v) != hash_type(genvar()));
+
+  SECTION("type_map")
+  {
+    type_map<int> map;
+    map.emplace(i, 1);
+    map.emplace(f, 2);
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.at(copy_type(i)) == 1);
+    REQUIRE(map.at(copy_type(f)) == 2);
+    REQUIRE(map.count(d) == 0);
+    REQUIRE(!map.emplace(copy_type(f), 3).second);
+
+    std::unordered_set<object_ptr<const Type>> set = {i, copy_type(i), d};
+    REQUIRE(set.size() == 3); // pointer equality
+    type_set tset = {i, copy_type(i), d};
+    REQUIRE(tset.size() == 2);
+  }
+}
+
+TEST_CASE("type_of_parallel")
+{
+  auto plus = make_object<PlusInt>();
+  auto id = make_object<Identity>();
+
+  // balanced tree of 2^depth leaves
+  auto tree = [&](auto&& self, size_t depth) -> object_ptr<const Object> {
+    if (depth == 0)
+      return id << make_object<Int>(1);
+    return plus << self(self, depth - 1) << self(self, depth - 1);
+  };
+
+  auto g = tree(tree, 10);
+
+  for (size_t grain : {1, 8, 100000}) {
+    auto t = type_of_parallel(g, 4, grain);
+    REQUIRE(same_type(t, object_type<Int>()));
+  }
+
+  // closure result
+  auto p = plus << g;
+  REQUIRE(same_type(type_of_parallel(p, 4, 8), type_of(p)));
+
+  SECTION("error")
+  {
+    auto bad = plus << g << (plus << g << make_object<Double>());
+    REQUIRE_THROWS_AS(type_of_parallel(bad, 4, 8), type_error::type_missmatch);
+    REQUIRE_THROWS_AS(
+      check_type_parallel<Double>(g, 4, 8), type_error::bad_type_check);
+    REQUIRE_NOTHROW(check_type_parallel<Int>(g, 4, 8));
+  }
+
+  SECTION("var id")
+  {
+    std::vector<uint64_t> ids[4];
+    std::vector<std::thread> ts;
+    for (auto&& v : ids)
+      ts.emplace_back([&] {
+        for (int i = 0; i < 5000; ++i)
+          v.push_back(get<var_type>(*genvar()).id);
+      });
+    for (auto&& t : ts)
+      t.join();
+
+    std::set<uint64_t> all;
+    for (auto&& v : ids)
+      all.insert(v.begin(), v.end());
+    REQUIRE(all.size() == 20000);
+  }
 }
\ No newline at end of file
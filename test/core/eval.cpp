@@ -140,4 +140,52 @@ TEST_CASE("Apply cache")
     REQUIRE(_get_storage(*app).evaluated());
     REQUIRE(_get_storage(*app).get_cache() == result);
   }
+}
+
+TEST_CASE("short-circuit eval")
+{
+  auto plus = make_object<PlusInt>();
+
+  SECTION("Apply inputs")
+  {
+    set_short_circuit_eval(true);
+
+    auto c = plus << new Int(1) << new Int(2);
+    auto p1 = plus << c << new Int(3);
+    // partial application which keeps its argument
+    auto p2 = plus << c;
+
+    REQUIRE(*eval(p1) == 6);
+    REQUIRE(c.use_count() == 2);
+
+    auto pap = eval(p2);
+    REQUIRE(c.use_count() == 1);
+    REQUIRE(*eval(pap << new Int(4)) == 7);
+
+    set_short_circuit_eval(false);
+  }
+
+  SECTION("closure arguments")
+  {
+    auto c = plus << new Int(1) << new Int(2);
+    auto pap = eval(plus << c);
+    // evaluates `c` without short-circuit
+    REQUIRE(*eval(pap << new Int(4)) == 7);
+    REQUIRE(c.use_count() == 2);
+
+    set_short_circuit_eval(true);
+    REQUIRE(*eval(pap << new Int(5)) == 8);
+    REQUIRE(c.use_count() == 1);
+    REQUIRE(*eval(pap << new Int(6)) == 9);
+    set_short_circuit_eval(false);
+  }
+
+  SECTION("disabled")
+  {
+    auto c = plus << new Int(1) << new Int(2);
+    auto p2 = plus << c;
+    REQUIRE(*eval(plus << c << new Int(3)) == 6);
+    auto pap = eval(p2);
+    REQUIRE(c.use_count() == 2);
+  }
 }
\ No newline at end of file
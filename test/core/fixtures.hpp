@@ -0,0 +1,41 @@
+// Fixtures shared by core tests
+
+#pragma once
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <vector>
+
+namespace {
+
+  /// Int addition which counts calls
+  struct Add : tori::Function<Add, tori::Int, tori::Int, tori::Int>
+  {
+    /// number of calls
+    static inline int calls = 0;
+
+    return_type code() const
+    {
+      ++calls;
+      return new tori::Int(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  /// balanced tree of additions over 1..n
+  inline tori::object_ptr<const tori::Object> build_sum_tree(
+    const tori::object_ptr<const tori::PlusInt>& plus,
+    size_t n)
+  {
+    std::vector<tori::object_ptr<const tori::Object>> nodes;
+    for (size_t i = 0; i < n; ++i)
+      nodes.push_back(tori::make_object<tori::Int>(int(i + 1)));
+    while (nodes.size() > 1) {
+      for (size_t i = 0; i < nodes.size() / 2; ++i)
+        nodes[i] = plus << nodes[2 * i] << nodes[2 * i + 1];
+      nodes.resize(nodes.size() / 2);
+    }
+    return nodes[0];
+  }
+
+} // namespace
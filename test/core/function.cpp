@@ -21,6 +21,9 @@ TEST_CASE("simple function test")
         return eval_arg<0>();
         return eval(arg<0>());
         return eval(eval_arg<0>());
+        return arg_ref<0>();
+        return eval_arg_ref<0>();
+        return eval(arg_ref<0>());
         return make_object<Int>();
         return make_object<const Int>();
         return new Int();
@@ -171,6 +174,73 @@ TEST_CASE("polymorphic function test")
   }
 }
 
+TEST_CASE("strict")
+{
+  static int count = 0;
+
+  struct Count : Function<Count, Int, Int>
+  {
+    return_type code() const
+    {
+      ++count;
+      return eval_arg<0>();
+    }
+  };
+
+  struct Const : Function<Const, strict<Int>, Int, Int>
+  {
+    return_type code() const
+    {
+      // strict argument is not a thunk
+      if (value_cast_if<Apply>(object_ptr<const Object>(arg<0>())))
+        throw std::runtime_error("not evaluated");
+      return arg<1>();
+    }
+  };
+
+  struct Fail : Function<Fail, Int, Int>
+  {
+    return_type code() const
+    {
+      throw std::runtime_error("fail");
+    }
+  };
+
+  count = 0;
+  auto c = make_object<Count>();
+  auto k = make_object<Const>();
+  auto i = make_object<Int>(42);
+
+  SECTION("type")
+  {
+    REQUIRE(same_type(
+      object_type<Const>(), object_type<closure<Int, Int, Int>>()));
+    static_assert(Const::strict_args == 1);
+  }
+
+  SECTION("eval")
+  {
+    auto pap = k << (c << i);
+    (void)eval(pap);
+    REQUIRE(count == 0);
+
+    // forced even when unused
+    REQUIRE(*eval(pap << i) == 42);
+    REQUIRE(count == 1);
+
+    REQUIRE_THROWS_AS(
+      eval(k << (make_object<Fail>() << i) << i),
+      result_error::exception_result);
+  }
+
+  SECTION("BinaryOperator")
+  {
+    auto plus = make_object<PlusInt>();
+    REQUIRE(*eval(plus << (c << i) << (c << i)) == 84);
+    REQUIRE(count == 2);
+  }
+}
+
 /* FIXME
 TEST_CASE("selfrec")
 {
@@ -188,4 +258,96 @@ TEST_CASE("selfrec")
   check_type<Int>(sr);
   auto r = eval(sr);
 }
-*/
\ No newline at end of file
+*/
+
+TEST_CASE("borrowed argument access")
+{
+  struct F : Function<F, Int, strict<Int>, Int>
+  {
+    return_type code() const
+    {
+      auto a = arg_ref<0>();
+      // lazy argument is replaced by its result
+      auto x = eval_arg_ref<0>();
+      REQUIRE(!value_cast_if<Apply>(object_ptr<const Object>(arg<0>())));
+      REQUIRE(arg_ref<0>() != a);
+      REQUIRE(arg_ref<0>() == x);
+      auto y = eval_arg_ref<1>();
+      return new Int(*x + *y + *eval_arg<0>());
+    }
+  };
+
+  auto f = make_object<F>();
+  auto x = make_object<Int>(1);
+  auto y = make_object<Int>(2);
+
+  auto plus = make_object<PlusInt>();
+  auto g = f << (plus << x << x) << y;
+
+  REQUIRE(*eval(g) == 6);
+  REQUIRE(x.use_count() == 1);
+  REQUIRE(y.use_count() == 1);
+}
+
+TEST_CASE("static_closure")
+{
+  SECTION("singleton")
+  {
+    auto plus = static_closure<PlusInt>();
+    REQUIRE(plus.is_static());
+    REQUIRE(plus == static_closure<PlusInt>());
+    REQUIRE(static_closure<MinusInt>() != object_ptr<const Object>(plus));
+
+    // copies do not change refcount
+    {
+      auto p = plus;
+      REQUIRE(p.is_static());
+    }
+    REQUIRE(plus.is_static());
+    REQUIRE(get_info_table(plus.get()) == get_closure_info_table<PlusInt>());
+  }
+
+  SECTION("apply")
+  {
+    auto x = make_object<Int>(1);
+    auto y = make_object<Int>(2);
+    auto plus = static_closure<PlusInt>();
+    auto app = plus << (plus << x << y) << y;
+    check_type<Int>(app);
+    REQUIRE(*eval(app) == 5);
+    REQUIRE(*static_eval(app) == 5);
+    REQUIRE(plus.is_static());
+    REQUIRE(x.use_count() == 1);
+  }
+
+  SECTION("library")
+  {
+    auto i = make_object<Int>(42);
+    auto b = make_object<Bool>(false);
+
+    auto id = static_closure<Identity>() << i;
+    REQUIRE(*eval(id) == 42);
+
+    auto if_ = static_closure<If>() << b << i << id;
+    REQUIRE(*value_cast<Int>(eval(if_)) == 42);
+
+    auto lt = static_closure<LessInt>() << i << i;
+    REQUIRE(*eval(lt) == false);
+
+    struct F : Function<F, closure<Int, Int>, Int, Int>
+    {
+      return_type code() const
+      {
+        auto n = eval_arg<1>();
+        if (*n == 0)
+          return n;
+        return arg<0>() << new Int(*n - 1);
+      }
+    };
+
+    auto fix = static_closure<Fix>() << static_closure<F>() << i;
+    REQUIRE(*value_cast<Int>(eval(fix)) == 0);
+    REQUIRE(static_closure<Fix>().is_static());
+    REQUIRE(static_closure<F>().is_static());
+  }
+}
\ No newline at end of file
@@ -0,0 +1,274 @@
+#define TORI_ENABLE_GC
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+#include <vector>
+
+using namespace tori;
+
+TEST_CASE("gc roots")
+{
+  static_assert(detail::gc_enabled);
+
+  SECTION("object_ptr")
+  {
+    auto i = make_object<Int>(42);
+    auto j = i;
+    REQUIRE(i.use_count() == 1);
+    REQUIRE(!i.is_static());
+  }
+
+  SECTION("unreachable")
+  {
+    auto i = make_object<Int>(42);
+    weak_object_ptr w = i;
+    gc_collect();
+    REQUIRE(w.expired());
+  }
+
+  SECTION("gc_root")
+  {
+    weak_object_ptr<Int> w;
+    {
+      gc_root r = make_object<Int>(42);
+      w = r.get();
+      gc_collect();
+      REQUIRE(!w.expired());
+      REQUIRE(*r == 42);
+
+      auto r2 = r;
+      r = gc_root<Int>();
+      gc_collect();
+      REQUIRE(!w.expired());
+      REQUIRE(*r2 == 42);
+    }
+    gc_collect();
+    REQUIRE(w.expired());
+  }
+
+  SECTION("add_gc_root")
+  {
+    auto i = make_object<Int>(42);
+    weak_object_ptr w = i;
+    add_gc_root(i);
+    add_gc_root(i);
+    remove_gc_root(i);
+    gc_collect();
+    REQUIRE(!w.expired());
+    remove_gc_root(i);
+    gc_collect();
+    REQUIRE(w.expired());
+  }
+
+  SECTION("static")
+  {
+    gc_root t = object_type<Int>();
+    auto plus = static_closure<PlusInt>();
+    gc_collect();
+    REQUIRE(t.get().is_static());
+    REQUIRE(plus.is_static());
+  }
+}
+
+TEST_CASE("gc graph")
+{
+  gc_collect();
+  auto base = get_gc_stats();
+
+  SECTION("eval")
+  {
+    gc_root g = build_sum_tree(make_object<PlusInt>(), 64);
+    REQUIRE(*value_cast<Int>(eval(g.get())) == 64 * 65 / 2);
+
+    // evaluated root only holds its cache
+    gc_collect();
+    REQUIRE(get_gc_stats().objects == base.objects + 2);
+    REQUIRE(get_gc_stats().collections == base.collections + 1);
+    REQUIRE(*value_cast<Int>(eval(g.get())) == 64 * 65 / 2);
+  }
+
+  SECTION("compact")
+  {
+    auto g = compact(build_sum_tree(make_object<PlusInt>(), 64));
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 64 * 65 / 2);
+
+    // caches of all 126 Apply nodes in compacted graph are kept
+    gc_collect();
+    REQUIRE(get_gc_stats().objects == base.objects + 126);
+    REQUIRE(*value_cast<Int>(eval(g.root())) == 64 * 65 / 2);
+
+    // copies are released with graph
+    weak_object_ptr<const Object> root = g.root();
+    g = compacted_graph();
+    REQUIRE(!root.lock());
+  }
+
+  SECTION("incremental_graph")
+  {
+    auto plus = make_object<PlusInt>();
+    auto l = plus << new Int(1) << new Int(2);
+    incremental_graph g {plus << l << new Int(3)};
+    REQUIRE(*value_cast<Int>(g.eval()) == 6);
+
+    // l is only referenced from side table of g
+    gc_collect();
+    g.set_arg(l, make_object<Int>(10));
+    REQUIRE(*value_cast<Int>(g.eval()) == 14);
+
+    // new input is kept while marking
+    auto x = make_object<Int>(20);
+    REQUIRE(!gc_step(1));
+    g.set_arg(l, x);
+    x = nullptr;
+    while (!gc_step(16))
+      ;
+    REQUIRE(*value_cast<Int>(g.eval()) == 24);
+  }
+
+  SECTION("closure")
+  {
+    auto x = make_object<Int>(1);
+    weak_object_ptr wx = x;
+
+    // partially applied closure holds x
+    gc_root pap = eval(make_object<PlusInt>() << x);
+    x = nullptr;
+    gc_collect();
+    REQUIRE(!wx.expired());
+    REQUIRE(*eval(pap.get() << new Int(2)) == 3);
+  }
+
+  SECTION("fix")
+  {
+    struct F : Function<F, closure<Int, Int>, Int, Int>
+    {
+      return_type code() const
+      {
+        auto n = eval_arg<1>();
+        if (*n == 0)
+          return n;
+        return arg<0>() << new Int(*n - 1);
+      }
+    };
+
+    {
+      auto fix = make_object<Fix>() << make_object<F>() << new Int(10);
+      REQUIRE(*value_cast<Int>(eval(fix)) == 0);
+    }
+
+    // self-referencing closures are released
+    gc_collect();
+    auto stats = get_gc_stats();
+    REQUIRE(stats.objects == base.objects);
+    REQUIRE(stats.freed > base.freed);
+  }
+}
+
+TEST_CASE("gc incremental")
+{
+  gc_collect();
+
+  gc_root g = build_sum_tree(make_object<PlusInt>(), 256);
+
+  // leaf of graph
+  weak_object_ptr<const Object> leaf;
+  {
+    object_ptr<const Object> n = g.get();
+    while (auto a = value_cast_if<Apply>(n))
+      n = _get_storage(*a).arg();
+    leaf = n;
+  }
+
+  // start marking
+  REQUIRE(!gc_step(1));
+
+  // inputs unlinked while marking are kept in this cycle
+  REQUIRE(*value_cast<Int>(eval(g.get())) == 256 * 257 / 2);
+
+  // objects allocated while marking survive
+  auto tmp = make_object<Int>(42);
+  weak_object_ptr wtmp = tmp;
+
+  while (!gc_step(16))
+    ;
+
+  REQUIRE(!leaf.expired());
+  REQUIRE(!wtmp.expired());
+  REQUIRE(*tmp == 42);
+  REQUIRE(*value_cast<Int>(eval(g.get())) == 256 * 257 / 2);
+
+  gc_collect();
+  REQUIRE(leaf.expired());
+  REQUIRE(wtmp.expired());
+  REQUIRE(*value_cast<Int>(eval(g.get())) == 256 * 257 / 2);
+}
+
+TEST_CASE("gc closure arguments")
+{
+  gc_collect();
+
+  auto plus = make_object<PlusInt>();
+  auto c = plus << new Int(1) << new Int(2);
+  gc_root pap = eval(plus << c);
+  REQUIRE(*value_cast<Int>(eval(c)) == 3);
+  c = nullptr;
+
+  // start marking
+  REQUIRE(!gc_step(1));
+
+  // argument of pap is replaced with result of c while marking
+  set_short_circuit_eval(true);
+  REQUIRE(*eval(pap.get() << new Int(4)) == 7);
+  set_short_circuit_eval(false);
+
+  while (!gc_step(16))
+    ;
+  REQUIRE(*eval(pap.get() << new Int(5)) == 8);
+
+  gc_collect();
+  REQUIRE(*eval(pap.get() << new Int(6)) == 9);
+}
+
+TEST_CASE("gc apply cache")
+{
+  gc_collect();
+  set_apply_cache_budget(1);
+
+  auto add = make_object<Add>();
+  auto make_node = [&](int i) {
+    return add << make_object<Int>(i) << make_object<Int>(1);
+  };
+
+  auto before = get_apply_cache_stats();
+
+  std::vector<gc_root<const Object>> nodes;
+  for (int i = 0; i < 4; ++i) {
+    nodes.emplace_back(make_node(i));
+    REQUIRE(*value_cast<Int>(eval(nodes.back().get())) == i + 1);
+  }
+
+  // budget is enforced
+  auto stats = get_apply_cache_stats();
+  REQUIRE(stats.evictions - before.evictions >= 4);
+  REQUIRE(stats.tracked == 8);
+
+  // unreachable nodes are dropped by collector
+  for (int i = 0; i < 4; ++i)
+    (void)eval(make_node(i));
+  REQUIRE(get_apply_cache_stats().tracked == 16);
+  gc_collect();
+  REQUIRE(get_apply_cache_stats().tracked == 8);
+
+  // inputs of evicted nodes survive collection
+  Add::calls = 0;
+  for (int i = 0; i < 4; ++i)
+    REQUIRE(*value_cast<Int>(eval(nodes[i].get())) == i + 1);
+  REQUIRE(Add::calls == 4);
+
+  set_apply_cache_budget(0);
+}
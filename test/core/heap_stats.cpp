@@ -0,0 +1,106 @@
+#define TORI_ENABLE_HEAP_STATS
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace tori;
+
+namespace {
+
+  template <class T>
+  heap_record find()
+  {
+    auto snapshot = get_heap_stats();
+    for (auto&& r : snapshot.records)
+      if (same_type(r.type, object_type<T>()))
+        return r;
+    return {object_type<T>(), 0, 0};
+  }
+
+} // namespace
+
+TEST_CASE("heap stats")
+{
+  auto base = find<Double>().live_objects;
+
+  SECTION("make_object")
+  {
+    {
+      auto d1 = make_object<Double>(1.0);
+      auto d2 = make_object<Double>(2.0);
+      auto r = find<Double>();
+      REQUIRE(r.live_objects == base + 2);
+      REQUIRE(r.live_bytes == r.live_objects * sizeof(Double));
+    }
+    REQUIRE(find<Double>().live_objects == base);
+  }
+
+  SECTION("clone")
+  {
+    auto d = make_object<Double>(1.0);
+    auto c = clone(d);
+    REQUIRE(find<Double>().live_objects == base + 2);
+    d = nullptr;
+    c = nullptr;
+    REQUIRE(find<Double>().live_objects == base);
+  }
+
+  SECTION("uncounted objects")
+  {
+    // not created by make_object
+    {
+      object_ptr<Double> d = new Double(1.0);
+      REQUIRE(find<Double>().live_objects == base);
+    }
+    REQUIRE(find<Double>().live_objects == base);
+  }
+
+  SECTION("eval")
+  {
+    auto add = make_object<Add>();
+    auto ints = find<Int>().live_objects;
+    {
+      auto r = eval(add << make_object<Int>(1) << make_object<Int>(2));
+      REQUIRE(*r == 3);
+      // returned from code()
+      REQUIRE(find<Int>().live_objects == ints + 1);
+      REQUIRE(find<Add>().live_objects >= 1);
+    }
+    REQUIRE(find<Int>().live_objects == ints);
+  }
+
+  SECTION("threads")
+  {
+    std::vector<object_ptr<Double>> ds(1000);
+    std::vector<std::thread> ts;
+    for (size_t t = 0; t < 4; ++t) {
+      ts.emplace_back([&, t] {
+        for (size_t i = t; i < ds.size(); i += 4)
+          ds[i] = make_object<Double>(double(i));
+      });
+    }
+    for (auto&& t : ts)
+      t.join();
+    REQUIRE(find<Double>().live_objects == base + 1000);
+
+    // release from main thread
+    ds.clear();
+    REQUIRE(find<Double>().live_objects == base);
+  }
+
+  SECTION("dump")
+  {
+    auto d = make_object<Double>(1.0);
+    std::stringstream ss;
+    dump_heap_stats(ss);
+    REQUIRE(ss.str().find("Double") != std::string::npos);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+using namespace tori;
+
+TEST_CASE("incremental_graph")
+{
+  auto add = make_object<Add>();
+  auto a = make_object<Int>(1);
+  auto b = make_object<Int>(2);
+  auto c = make_object<Int>(3);
+
+  // (a + b) + (c + c)
+  auto l = add << a << b;
+  auto r = add << c << c;
+  auto root = add << l << r;
+
+  incremental_graph g {root};
+  REQUIRE(g.node_count() == 6);
+
+  Add::calls = 0;
+  REQUIRE(*value_cast<Int>(g.eval()) == 9);
+  REQUIRE(Add::calls == 3);
+
+  SECTION("cached")
+  {
+    Add::calls = 0;
+    REQUIRE(*value_cast<Int>(g.eval()) == 9);
+    REQUIRE(Add::calls == 0);
+  }
+
+  SECTION("set_arg")
+  {
+    Add::calls = 0;
+    g.set_arg(l, make_object<Int>(10));
+    // l, (add l), root
+    REQUIRE(g.invalidated_count() == 3);
+    REQUIRE(*value_cast<Int>(g.eval()) == 17);
+    REQUIRE(Add::calls == 2);
+    REQUIRE(_get_storage(*r).evaluated());
+  }
+
+  SECTION("invalidate leaf")
+  {
+    Add::calls = 0;
+    *c = 4;
+    g.invalidate(c);
+    REQUIRE(*value_cast<Int>(g.eval()) == 11);
+    REQUIRE(Add::calls == 2);
+    REQUIRE(_get_storage(*l).evaluated());
+  }
+
+  SECTION("set_arg subgraph")
+  {
+    Add::calls = 0;
+    g.set_arg(root, add << c << b);
+    // r and (add c) are detached
+    REQUIRE(g.node_count() == 6);
+    REQUIRE(*value_cast<Int>(g.eval()) == 8);
+    REQUIRE(Add::calls == 2);
+
+    Add::calls = 0;
+    *b = 0;
+    g.invalidate(b);
+    // l, (add c b), root
+    REQUIRE(*value_cast<Int>(g.eval()) == 4);
+    REQUIRE(Add::calls == 3);
+  }
+
+  SECTION("repeated edits")
+  {
+    for (int i = 0; i < 100; ++i) {
+      g.set_arg(root, add << make_object<Int>(i) << c);
+      g.set_app(l, add << b);
+      REQUIRE(*value_cast<Int>(g.eval()) == 2 + 2 + i + 3);
+    }
+    REQUIRE(g.node_count() == 6);
+
+    // shared input is kept
+    g.set_arg(root, add << l << r);
+    REQUIRE(g.node_count() == 6);
+    REQUIRE(*value_cast<Int>(g.eval()) == 4 + 4 + 6);
+  }
+
+  SECTION("not a node")
+  {
+    REQUIRE_THROWS_AS(g.set_arg(a, b), std::invalid_argument);
+  }
+}
+
+TEST_CASE("incremental_graph deep")
+{
+  auto add = make_object<Add>();
+  auto one = make_object<Int>(1);
+
+  object_ptr<const Object> chain = one;
+  for (int i = 0; i < 100000; ++i)
+    chain = add << chain << one;
+
+  {
+    incremental_graph g {chain};
+    REQUIRE(g.node_count() == 200000);
+  }
+
+  // release from root to not recurse in destructors
+  while (auto apply = value_cast_if<Apply>(chain)) {
+    auto app = value_cast<Apply>(_get_storage(*apply).app());
+    chain = _get_storage(*app).arg();
+  }
+}
@@ -0,0 +1,202 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace tori;
+
+namespace {
+
+  struct Counted
+  {
+    Counted(int v)
+      : value {v}
+    {
+      ++live;
+      max_live = std::max(max_live, live);
+    }
+    Counted(const Counted& other)
+      : Counted(other.value)
+    {
+    }
+    ~Counted() noexcept
+    {
+      --live;
+    }
+
+    int value;
+
+    static inline int live = 0;
+    static inline int max_live = 0;
+  };
+
+} // namespace
+
+namespace tori {
+  using CountedObj = Box<Counted>;
+  using CountedList = List<CountedObj>;
+} // namespace tori
+
+TORI_DECL_TYPE(CountedObj)
+TORI_DECL_TYPE(CountedList)
+
+namespace {
+
+  struct Succ : Function<Succ, CountedObj, CountedObj>
+  {
+    return_type code() const
+    {
+      return make_object<CountedObj>(eval_arg<0>()->value + 1);
+    }
+  };
+
+  struct Sum : Function<Sum, Long, CountedObj, Long>
+  {
+    return_type code() const
+    {
+      return make_object<Long>(*eval_arg<0>() + eval_arg<1>()->value);
+    }
+  };
+
+  struct Inc : Function<Inc, Int, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() + 1);
+    }
+  };
+
+  struct Twice : Function<Twice, Int, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() * 2);
+    }
+  };
+
+  struct IsOdd : Function<IsOdd, Int, Bool>
+  {
+    return_type code() const
+    {
+      return make_object<Bool>(*eval_arg<0>() % 2 != 0);
+    }
+  };
+
+  struct Count : Function<Count, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      ++calls;
+      return make_object<Int>(*eval_arg<0>() + 1);
+    }
+    static inline int calls = 0;
+  };
+
+  struct CountOdd : Function<CountOdd, Int, Bool, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() + (*eval_arg<1>() ? 1 : 0));
+    }
+  };
+
+  struct Throw : Function<Throw, Int, Int>
+  {
+    return_type code() const
+    {
+      throw std::runtime_error("throw");
+    }
+  };
+
+} // namespace
+
+TEST_CASE("List")
+{
+  auto cons = make_object<Cons<Int>>();
+  auto nil = make_object<IntList>();
+  auto plus = make_object<PlusInt>();
+  auto fold = make_object<FoldL<Int>>();
+  auto nats = make_object<Iterate<Int>>() << make_object<Inc>() << new Int(0);
+
+  SECTION("Cons")
+  {
+    auto xs = cons << new Int(1) << (cons << new Int(2) << nil);
+    REQUIRE(*eval(fold << plus << new Int(0) << xs) == 3);
+    REQUIRE(*eval(fold << plus << new Int(5) << nil) == 5);
+    // lists are not consumed by traversal
+    REQUIRE(*eval(fold << plus << new Int(0) << xs) == 3);
+  }
+
+  SECTION("pipeline")
+  {
+    auto map = make_object<Map<Int>>();
+    auto odd = make_object<Filter<Int>>() << make_object<IsOdd>();
+    auto take = make_object<Take<Int>>();
+
+    auto xs = map << make_object<Inc>() << nats;
+
+    // sum (take 3 (filter odd (map (+1) [0..])))
+    auto ws = take << new Int(3) << (odd << xs);
+    REQUIRE(*eval(fold << plus << new Int(0) << ws) == 1 + 3 + 5);
+
+    // sum (take 5 (map (*2) (map (+1) [0..])))
+    auto zs = take << new Int(5) << (map << make_object<Twice>() << xs);
+    REQUIRE(*eval(fold << plus << new Int(0) << zs) == 2 + 4 + 6 + 8 + 10);
+
+    // source is not evaluated after limit, even when nothing passes filter
+    auto evens = odd << (map << make_object<Twice>() << xs);
+    auto none = take << new Int(0) << evens;
+    REQUIRE(*eval(fold << plus << new Int(0) << none) == 0);
+
+    // take is applied in order
+    auto t = take << new Int(2) << (take << new Int(4) << nats);
+    REQUIRE(*eval(fold << plus << new Int(0) << t) == 1);
+
+    // map does not evaluate elements
+    auto e = take << new Int(3) << (map << make_object<Throw>() << nats);
+    auto count = make_object<FoldL<Int>>() << make_object<Count>();
+    REQUIRE(*eval(count << new Int(0) << e) == 3);
+    REQUIRE_THROWS_AS(
+      eval(fold << plus << new Int(0) << e), result_error::exception_result);
+
+    // element type can change
+    auto m = make_object<Map<Int, Bool>>() << make_object<IsOdd>();
+    auto bs = make_object<Take<Bool>>() << new Int(4) << (m << nats);
+    auto bfold = make_object<FoldL<Bool, Int>>() << make_object<CountOdd>();
+    REQUIRE(*eval(bfold << new Int(0) << bs) == 2);
+  }
+
+  SECTION("pipeline in tail")
+  {
+    auto map = make_object<Map<Int>>();
+    auto take = make_object<Take<Int>>();
+    auto ys = map << make_object<Twice>() << (take << new Int(3) << nats);
+    auto xs = cons << new Int(100) << ys;
+    REQUIRE(*eval(fold << plus << new Int(0) << (take << new Int(3) << xs)) ==
+            100 + 0 + 2);
+  }
+
+  SECTION("types")
+  {
+    auto m = make_object<Map<Int>>() << make_object<Twice>() << nats;
+    REQUIRE(same_type(type_of(m), object_type<IntList>()));
+    REQUIRE(!same_type(object_type<IntList>(), object_type<DoubleList>()));
+  }
+}
+
+TEST_CASE("List constant memory")
+{
+  constexpr int n = 100000;
+
+  auto src = make_object<Iterate<CountedObj>>() << make_object<Succ>()
+                                                 << new CountedObj(0);
+  auto xs = make_object<Take<CountedObj>>() << new Int(n) << src;
+  auto sum = make_object<FoldL<CountedObj, Long>>() << make_object<Sum>();
+
+  Counted::max_live = Counted::live;
+  auto base = Counted::live;
+
+  auto r = eval(sum << new Long(0) << xs);
+  REQUIRE(*r == int64_t(n) * (n - 1) / 2);
+  REQUIRE(Counted::max_live - base < 10);
+}
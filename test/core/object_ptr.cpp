@@ -132,4 +132,42 @@ TEST_CASE("value_cast")
     REQUIRE(!value_cast_if<Double>(i));
     REQUIRE(*value_cast_if<Int>(i) == 42);
   }
+}
+
+TEST_CASE("object_ref")
+{
+  auto i = make_object<Int>(42);
+
+  object_ref<const Object> r = i;
+  REQUIRE(r.get() == i.get());
+  REQUIRE(i.use_count() == 1);
+
+  auto ri = value_cast_if<Int>(r);
+  REQUIRE(ri);
+  REQUIRE(*ri == 42);
+  REQUIRE(!value_cast_if<Double>(r));
+  REQUIRE_THROWS_AS(value_cast<Double>(r), bad_value_cast);
+  REQUIRE(i.use_count() == 1);
+
+  {
+    // take reference
+    object_ptr<const Int> p = ri;
+    REQUIRE(i.use_count() == 2);
+    REQUIRE(object_ref(p) == ri);
+  }
+  REQUIRE(i.use_count() == 1);
+
+  REQUIRE(*eval(ri) == 42);
+  REQUIRE(i.use_count() == 1);
+
+  REQUIRE(!object_ref<Int>());
+  REQUIRE(!object_ref<Int>(nullptr));
+
+  // clang-format off
+  static_assert(std::is_constructible_v<object_ref<const Object>, object_ptr<Int>>);
+  static_assert(std::is_constructible_v<object_ref<const Object>, object_ref<Int>>);
+  static_assert(!std::is_constructible_v<object_ref<Int>, object_ref<const Object>>);
+  static_assert(std::is_convertible_v<object_ref<Int>, object_ptr<const Object>>);
+  static_assert(!std::is_convertible_v<object_ref<const Int>, object_ptr<Int>>);
+  // clang-format on
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+using namespace tori;
+
+namespace {
+
+  struct Sub : Function<Sub, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return new Int(*eval_arg<0>() - *eval_arg<1>());
+    }
+  };
+
+  struct Not : Function<Not, Bool, Bool>
+  {
+    return_type code() const
+    {
+      return new Bool(!*eval_arg<0>());
+    }
+  };
+
+  struct Throw : Function<Throw, Int, Int>
+  {
+    return_type code() const
+    {
+      throw std::runtime_error("throw");
+    }
+  };
+
+  size_t pass_rewrites(const graph_optimizer& opt, const std::string& name)
+  {
+    for (auto&& p : opt.stats().passes)
+      if (p.name == name)
+        return p.rewrites;
+    return size_t(-1);
+  }
+
+} // namespace
+
+TEST_CASE("optimize")
+{
+  auto i1 = make_object<Int>(1);
+  auto i2 = make_object<Int>(2);
+
+  SECTION("constant folding")
+  {
+    auto plus = make_object<PlusInt>();
+    auto sub = make_object<Sub>();
+
+    graph_optimizer opt;
+
+    // BinaryOperator is foldable by default
+    auto r = opt.optimize(plus << (plus << i1 << i2) << i2);
+    REQUIRE(value_cast<Int>(r));
+    REQUIRE(*value_cast<Int>(r) == 5);
+    REQUIRE(pass_rewrites(opt, "constant_folding") == 2);
+    REQUIRE(opt.stats().nodes_before == 4);
+    REQUIRE(opt.stats().nodes_after == 0);
+
+    // not marked
+    auto g = sub << i1 << i2;
+    r = opt.optimize(g);
+    REQUIRE(r == g);
+    REQUIRE(pass_rewrites(opt, "constant_folding") == 0);
+
+    mark_foldable<Sub>();
+    r = opt.optimize(g);
+    REQUIRE(*value_cast<Int>(r) == -1);
+    // input graph is not modified
+    REQUIRE(!_get_storage(*g).evaluated());
+
+    // partial application
+    auto p = plus << i1;
+    REQUIRE(opt.optimize(p) == p);
+  }
+
+  SECTION("exception")
+  {
+    mark_foldable<Throw>();
+    object_ptr<const Object> g = make_object<Throw>() << i1;
+    graph_optimizer opt;
+    REQUIRE(opt.optimize(g) == g);
+    REQUIRE_THROWS_AS(eval(g), result_error::exception_result);
+  }
+
+  SECTION("if pruning")
+  {
+    auto _if = make_object<If>();
+    auto plus = make_object<PlusInt>();
+    auto t = make_object<Bool>(true);
+
+    graph_optimizer opt;
+
+    auto g = _if << t << i1 << (plus << i2 << i2);
+    REQUIRE(opt.optimize(g) == i1);
+    REQUIRE(pass_rewrites(opt, "if_pruning") == 1);
+    REQUIRE(pass_rewrites(opt, "constant_folding") == 1);
+
+    // condition is folded first
+    auto lt = make_object<LessInt>();
+    auto g2 = _if << (lt << i2 << i1) << i1 << i2;
+    REQUIRE(opt.optimize(g2) == i2);
+
+    // condition is reduced by other rules first
+    auto g3 = _if << (make_object<Identity>() << t) << i1 << i2;
+    REQUIRE(opt.optimize(g3) == i1);
+
+    // unknown condition
+    auto g4 = _if << (make_object<Not>() << t) << i1 << i2;
+    REQUIRE(opt.optimize(g4) == g4);
+  }
+
+  SECTION("identity elimination")
+  {
+    auto id = make_object<Identity>();
+    auto add = make_object<Add>();
+    auto x = add << i1;
+
+    graph_optimizer opt;
+    auto g = add << (id << (id << i1)) << (id << i2);
+    auto r = opt.optimize(g);
+    REQUIRE(pass_rewrites(opt, "identity_elimination") == 3);
+    REQUIRE(*value_cast<Int>(eval(r)) == 3);
+
+    // Identity << closure
+    REQUIRE(opt.optimize(id << x) == x);
+  }
+
+  SECTION("dead subgraph")
+  {
+    auto add = make_object<Add>();
+    auto id = make_object<Identity>();
+
+    object_ptr<const Object> e = add << i1 << i2;
+    (void)eval(e);
+
+    graph_optimizer opt;
+    auto r = opt.optimize(id << e);
+    REQUIRE(pass_rewrites(opt, "dead_subgraph_removal") == 1);
+    REQUIRE(value_cast<Int>(r));
+    REQUIRE(opt.stats().nodes_before == 2);
+    REQUIRE(opt.stats().nodes_after == 0);
+  }
+
+  SECTION("sharing")
+  {
+    auto add = make_object<Add>();
+    auto id = make_object<Identity>();
+
+    auto shared = add << (id << i1);
+    auto g = shared << (shared << i2);
+
+    auto r = optimize(g);
+    auto& s = _get_storage(*value_cast<Apply>(r));
+    auto& s2 = _get_storage(*value_cast<Apply>(s.arg()));
+    REQUIRE(s.app() == s2.app());
+    REQUIRE(*value_cast<Int>(eval(r)) == 4);
+  }
+
+  SECTION("custom rule")
+  {
+    auto add = make_object<Add>();
+    auto zero = make_object<Int>(0);
+
+    // Add << 0 << x => x
+    graph_optimizer opt;
+    opt.add_rule("add_zero", [&](const object_ptr<const Apply>& apply) {
+      auto& s = _get_storage(*apply);
+      auto lhs = value_cast_if<Apply>(s.app());
+      if (!lhs || _get_storage(*lhs).evaluated())
+        return object_ptr<const Object>();
+      auto& ls = _get_storage(*lhs);
+      auto c = value_cast_if<Int>(ls.arg());
+      if (ls.app() == add && c && *c == 0)
+        return s.arg();
+      return object_ptr<const Object>();
+    });
+
+    auto x = add << i1;
+    auto r = opt.optimize(x << (add << zero << (x << i2)));
+    REQUIRE(opt.stats().passes.back().name == "add_zero");
+    REQUIRE(opt.stats().passes.back().rewrites == 1);
+    REQUIRE(opt.stats().nodes_after == 3);
+    REQUIRE(*value_cast<Int>(eval(r)) == 4);
+  }
+}
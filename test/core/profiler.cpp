@@ -0,0 +1,91 @@
+#define TORI_ENABLE_PROFILER
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+#include <sstream>
+
+using namespace tori;
+
+namespace {
+
+  struct Fail : Function<Fail, Int, Int>
+  {
+    return_type code() const
+    {
+      throw std::runtime_error("fail");
+    }
+  };
+
+  profile_counters find(
+    const profile_snapshot& snapshot,
+    const object_ptr<const Type>& type)
+  {
+    for (auto&& r : snapshot.records)
+      if (same_type(r.type, type))
+        return r.counters;
+    return {};
+  }
+
+} // namespace
+
+TEST_CASE("profiler")
+{
+  reset_profile();
+
+  SECTION("calls")
+  {
+    auto add = make_object<Add>();
+    auto i = make_object<Int>(1);
+    auto shared = add << i << i;
+    auto app = add << shared << shared;
+    REQUIRE(*eval(app) == 4);
+
+    auto snapshot = get_profile();
+    auto c = find(snapshot, object_type<Add>());
+    REQUIRE(c.calls == 2);
+    REQUIRE(c.exceptions == 0);
+    // results of both calls, and clones for (add i) and (add i i) made by
+    // eval_arg in outer call
+    REQUIRE(c.allocations == 4);
+    REQUIRE(c.inclusive_ns >= c.exclusive_ns);
+    // (add i), (add i i), (add shared), (add shared shared)
+    REQUIRE(snapshot.cache_misses == 4);
+    // second access to shared
+    REQUIRE(snapshot.cache_hits == 1);
+  }
+
+  SECTION("exception")
+  {
+    auto app = make_object<Fail>() << make_object<Int>(1);
+    REQUIRE_THROWS_AS(eval(app), result_error::exception_result);
+
+    auto c = find(get_profile(), object_type<Fail>());
+    REQUIRE(c.calls == 1);
+    REQUIRE(c.exceptions == 1);
+  }
+
+  SECTION("reset")
+  {
+    auto app = make_object<Add>() << make_object<Int>(1) << make_object<Int>(2);
+    (void)eval(app);
+    reset_profile();
+    auto snapshot = get_profile();
+    REQUIRE(find(snapshot, object_type<Add>()).calls == 0);
+    REQUIRE(snapshot.cache_misses == 0);
+  }
+
+  SECTION("dump")
+  {
+    auto app = make_object<Add>() << make_object<Int>(1) << make_object<Int>(2);
+    (void)eval(app);
+    std::stringstream ss;
+    dump_profile(ss);
+    REQUIRE(
+      ss.str().find(to_string(object_type<Add>())) != std::string::npos);
+  }
+}
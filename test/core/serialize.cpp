@@ -0,0 +1,210 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace tori;
+using namespace tori::detail;
+
+namespace {
+
+  archive_registry make_registry()
+  {
+    archive_registry r;
+    r.register_box<Int>();
+    r.register_box<Double>();
+    r.register_box<Bool>();
+    r.register_closure<Add>("test::Add");
+    return r;
+  }
+
+  /// release long chain of Apply nodes from root, without recursion of
+  /// destructors.
+  void release_chain(object_ptr<const Object>& obj)
+  {
+    auto root = std::move(obj);
+    std::vector<object_ptr<const Object>> nodes;
+    while (auto apply = value_cast_if<Apply>(root)) {
+      nodes.push_back(root);
+      root = _get_storage(*apply).app();
+      nodes.push_back(root);
+      if (auto app = value_cast_if<Apply>(root))
+        root = _get_storage(*app).arg();
+    }
+    for (auto&& n : nodes)
+      n = nullptr;
+  }
+
+  struct temp_file
+  {
+    std::string path = "tori_serialize_test.bin";
+    ~temp_file()
+    {
+      std::remove(path.c_str());
+    }
+  };
+
+} // namespace
+
+TEST_CASE("serialize primitives")
+{
+  auto registry = make_registry();
+
+  SECTION("box")
+  {
+    auto bytes = serialize_graph(
+      {make_object<Int>(42),
+       make_object<Double>(3.14),
+       make_object<String>("abc")},
+      registry);
+    graph_archive ar {bytes.data(), bytes.size(), registry};
+    REQUIRE(ar.root_count() == 3);
+    REQUIRE(*value_cast<Int>(ar.root(0)) == 42);
+    REQUIRE(*value_cast<Double>(ar.root(1)) == 3.14);
+    REQUIRE(std::string(value_cast<String>(ar.root(2))->c_str()) == "abc");
+  }
+
+  SECTION("type")
+  {
+    auto t = make_object<Type>(
+      arrow_type {object_type<Int>(), make_object<Type>(arrow_type {
+                                        object_type<Double>(), genvar()})});
+    auto bytes = serialize_graph({t}, registry);
+    graph_archive ar {bytes.data(), bytes.size(), registry};
+    auto r = value_cast<Type>(ar.root(0));
+    auto arrow = get_if<arrow_type>(r.value());
+    REQUIRE(arrow);
+    // value types are resolved to static type objects
+    REQUIRE(arrow->captured == object_type<Int>());
+    REQUIRE(is_var_type(get<arrow_type>(*arrow->returns).returns));
+  }
+
+  SECTION("unregistered")
+  {
+    REQUIRE_THROWS_AS(
+      serialize_graph({make_object<Float>(1.f)}, registry), serialize_error);
+  }
+}
+
+TEST_CASE("serialize apply graph")
+{
+  auto registry = make_registry();
+  temp_file tmp;
+
+  SECTION("sharing")
+  {
+    auto add = make_object<Add>();
+    auto i = make_object<Int>(1);
+    auto shared = add << i << i;
+    auto app = add << shared << shared;
+
+    save_graph(tmp.path, {app}, registry);
+
+    graph_archive ar {tmp.path, registry};
+    // Add, Int, (Add Int), (Add Int Int), (Add (..)), (Add (..) (..))
+    REQUIRE(ar.node_count() == 6);
+    REQUIRE(ar.materialized_count() == 0);
+
+    auto loaded = ar.root(0);
+    REQUIRE(ar.materialized_count() == 6);
+    REQUIRE(same_type(type_of(loaded), object_type<Int>()));
+    REQUIRE(*value_cast<Int>(eval(loaded)) == 4);
+  }
+
+  SECTION("evaluated")
+  {
+    auto add = make_object<Add>();
+    auto app = add << make_object<Int>(1) << make_object<Int>(2);
+    auto pap = add << make_object<Int>(3);
+    (void)eval(app);
+    (void)eval(pap);
+
+    save_graph(tmp.path, {app, pap}, registry);
+    graph_archive ar {tmp.path, registry};
+
+    // evaluated apply is stored as result
+    REQUIRE(*value_cast<Int>(ar.root(0)) == 3);
+    REQUIRE(ar.materialized_count() == 1);
+
+    // partially applied closure
+    auto p = ar.root(1);
+    REQUIRE(has_arrow_type(p));
+    auto r = eval(object_ptr<const Object>(p << make_object<Int>(4)));
+    REQUIRE(*value_cast<Int>(r) == 7);
+  }
+
+  SECTION("long chain")
+  {
+    auto add = make_object<Add>();
+    auto one = make_object<Int>(1);
+    auto x = object_ptr<const Object>(one);
+    for (int i = 0; i < 20000; ++i)
+      x = add << x << one;
+
+    // no recursion per level
+    auto bytes = serialize_graph({x}, registry);
+    object_ptr<const Object> root;
+    {
+      graph_archive ar {bytes.data(), bytes.size(), registry};
+      REQUIRE(ar.node_count() == 2 + 2 * 20000);
+      root = ar.root(0);
+      REQUIRE(ar.materialized_count() == ar.node_count());
+    }
+    release_chain(root);
+    release_chain(x);
+  }
+
+  SECTION("bad reference")
+  {
+    auto add = make_object<Add>();
+    auto bytes = serialize_graph({add << make_object<Int>(1)}, registry);
+
+    archive_header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    REQUIRE(header.node_count == 3);
+
+    // make Apply node refer itself
+    uint64_t offset;
+    std::memcpy(
+      &offset,
+      bytes.data() + header.offset_table + 2 * sizeof(uint64_t),
+      sizeof(offset));
+    uint64_t self = 2;
+    std::memcpy(
+      bytes.data() + offset + sizeof(archive_record_header) + 8,
+      &self,
+      sizeof(self));
+
+    graph_archive ar {bytes.data(), bytes.size(), registry};
+    REQUIRE_THROWS_AS(ar.root(0), serialize_error);
+  }
+
+  SECTION("bad table")
+  {
+    auto bytes = serialize_graph({make_object<Int>(1)}, registry);
+
+    // offset + count * 8 overflows
+    archive_header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.node_count = ~uint64_t(0) / 8 + 1;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    REQUIRE_THROWS_AS(
+      (graph_archive {bytes.data(), bytes.size(), registry}),
+      serialize_error);
+  }
+
+  SECTION("broken file")
+  {
+    {
+      std::ofstream ofs(tmp.path, std::ios::binary);
+      ofs << "not an archive, but long enough to have header......";
+    }
+    REQUIRE_THROWS_AS((graph_archive {tmp.path, registry}), serialize_error);
+  }
+}
\ No newline at end of file
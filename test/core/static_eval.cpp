@@ -0,0 +1,87 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+using namespace tori;
+
+namespace {
+
+  struct Choose : Function<Choose, strict<Bool>, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      if (*eval_arg<0>())
+        return arg<1>();
+      return arg<2>();
+    }
+  };
+
+  struct Fail : Function<Fail, Int, Int>
+  {
+    return_type code() const
+    {
+      throw std::runtime_error("fail");
+    }
+  };
+
+} // namespace
+
+TEST_CASE("static_eval")
+{
+  auto plus = make_object<PlusInt>();
+  auto add = make_object<Add>();
+  auto i = make_object<Int>(1);
+
+  SECTION("strict")
+  {
+    auto g = plus << (plus << i << i) << (plus << i << make_object<Int>(2));
+    auto r = static_eval(g);
+    REQUIRE(*r == 5);
+    // cached
+    REQUIRE(eval(g) == r);
+    REQUIRE(static_eval(g) == r);
+    // closure is not modified
+    REQUIRE(*static_eval(plus << i << i) == 2);
+  }
+
+  SECTION("lazy")
+  {
+    Add::calls = 0;
+    auto g = add << (add << i << i) << i;
+    REQUIRE(*static_eval(g) == 3);
+    REQUIRE(Add::calls == 2);
+
+    auto fail = make_object<Fail>() << i;
+    auto choose = make_object<Choose>();
+    auto c1 = choose << (make_object<LessInt>() << i << i) << fail << i;
+    auto c2 = choose << (make_object<LessInt>() << i << i) << i << fail;
+    REQUIRE(*static_eval(c1) == 1);
+    REQUIRE_THROWS_AS(static_eval(c2), result_error::exception_result);
+  }
+
+  SECTION("exception")
+  {
+    auto fail = make_object<Fail>() << i;
+    REQUIRE_THROWS_AS(
+      static_eval(plus << fail << i), result_error::exception_result);
+    REQUIRE_THROWS_AS(
+      eval(plus << fail << i), result_error::exception_result);
+  }
+
+  SECTION("partial application")
+  {
+    auto pap = static_eval(plus << i);
+    REQUIRE(*eval(pap << make_object<Int>(2)) == 3);
+  }
+
+  SECTION("fallback")
+  {
+    // partial application node is already evaluated
+    auto p = plus << i;
+    REQUIRE(*eval(p << i) == 2);
+    REQUIRE(*static_eval(p << make_object<Int>(2)) == 3);
+  }
+}
\ No newline at end of file
@@ -134,6 +134,12 @@ void test_set_eq()
     static_assert(set_c<int, int> == set_c<int>);
     static_assert(set_c<int, double> != set_c<int>);
   }
+  {
+    // keeps first occurrences in order
+    static_assert(
+      make_tuple(set_c<int, double, int, float, double>) ==
+      tuple_c<int, double, float>);
+  }
 }
 
 void test_set_insert()
@@ -345,6 +351,21 @@ void test_genpoly()
 
     static_assert(genpoly(term, gen_c<0>).first() == gterm);
   }
+  {
+    // X -> Y -> X
+    constexpr auto term = type_c<
+      tm_closure<tm_var<class X>, tm_var<class Y>, tm_var<class X>>>;
+
+    // vars are numbered by first occurrence
+    constexpr auto gterm = type_c<tm_closure<
+      tm_var<taggen<2>>,
+      tm_var<taggen<3>>,
+      tm_var<taggen<2>>>>;
+
+    constexpr auto p = genpoly(term, gen_c<2>);
+    static_assert(p.first() == gterm);
+    static_assert(p.second() == gen_c<5>);
+  }
 }
 
 void test_assume_object_type()
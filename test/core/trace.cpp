@@ -0,0 +1,105 @@
+#define TORI_ENABLE_TRACE
+#define TORI_TRACE_BUFFER_SIZE 16
+
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "fixtures.hpp"
+
+#include <thread>
+#include <sstream>
+
+using namespace tori;
+
+namespace {
+
+  object_ptr<const Object> make_add(int l, int r)
+  {
+    return make_object<Add>() << make_object<Int>(l) << make_object<Int>(r);
+  }
+
+} // namespace
+
+TEST_CASE("trace")
+{
+  clear_trace();
+
+  SECTION("stopped")
+  {
+    REQUIRE(!is_tracing());
+    (void)eval(make_add(1, 2));
+    REQUIRE(get_trace().empty());
+  }
+
+  SECTION("nesting")
+  {
+    start_trace();
+    (void)eval(make_add(1, 2));
+    stop_trace();
+
+    auto events = get_trace();
+    REQUIRE(events.size() == 6);
+
+    using p = trace_phase;
+    using k = trace_kind;
+    std::pair<p, k> expected[] = {{p::begin, k::eval},
+                                  {p::begin, k::eval},
+                                  {p::end, k::eval},
+                                  {p::begin, k::code},
+                                  {p::end, k::code},
+                                  {p::end, k::eval}};
+
+    for (size_t i = 0; i < events.size(); ++i) {
+      REQUIRE(events[i].phase == expected[i].first);
+      REQUIRE(events[i].kind == expected[i].second);
+      if (i > 0)
+        REQUIRE(events[i - 1].timestamp <= events[i].timestamp);
+    }
+    REQUIRE(same_type(events[3].type, object_type<Add>()));
+    REQUIRE(!events[0].type);
+  }
+
+  SECTION("ring buffer")
+  {
+    // 4 graphs make 24 events, buffer holds 16
+    start_trace();
+    for (int i = 0; i < 4; ++i) (void)eval(make_add(i, i));
+    stop_trace();
+
+    auto events = get_trace();
+    REQUIRE(!events.empty());
+    REQUIRE(events.size() <= 16);
+    REQUIRE(events.front().phase == trace_phase::begin);
+  }
+
+  SECTION("threads")
+  {
+    start_trace();
+    std::thread t1 {[] { (void)eval(make_add(1, 2)); }};
+    std::thread t2 {[] { (void)eval(make_add(3, 4)); }};
+    t1.join();
+    t2.join();
+    stop_trace();
+
+    auto events = get_trace();
+    REQUIRE(events.size() == 12);
+    REQUIRE(events.front().thread != events.back().thread);
+  }
+
+  SECTION("chrome trace")
+  {
+    start_trace();
+    (void)eval(make_add(1, 2));
+    stop_trace();
+
+    std::stringstream ss;
+    dump_chrome_trace(ss);
+    auto json = ss.str();
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("\"ph\":\"B\"") != std::string::npos);
+    REQUIRE(json.find("\"ph\":\"E\"") != std::string::npos);
+    REQUIRE(json.find(to_string(object_type<Add>())) != std::string::npos);
+  }
+}
@@ -0,0 +1,125 @@
+#include <tori/core.hpp>
+#include <tori/lib.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+#include <atomic>
+
+using namespace tori;
+
+TEST_CASE("weak_object_ptr")
+{
+  SECTION("null")
+  {
+    weak_object_ptr<Int> w;
+    REQUIRE(w.expired());
+    REQUIRE(!w.lock());
+    REQUIRE(weak_object_ptr(object_ptr<Int>()).expired());
+  }
+
+  SECTION("lock")
+  {
+    auto i = make_object<Int>(42);
+    weak_object_ptr w = i;
+
+    // weak references are not counted
+    REQUIRE(i.use_count() == 1);
+    REQUIRE(!w.expired());
+
+    auto l = w.lock();
+    REQUIRE(l == i);
+    REQUIRE(*l == 42);
+    REQUIRE(i.use_count() == 2);
+
+    l = nullptr;
+    i = nullptr;
+    REQUIRE(w.expired());
+    REQUIRE(!w.lock());
+  }
+
+  SECTION("copy")
+  {
+    auto i = make_object<Int>(42);
+    weak_object_ptr<Int> w1 = i;
+    weak_object_ptr<Int> w2 = w1;
+    weak_object_ptr<const Object> w3 = w2;
+    weak_object_ptr<Int> w4 = std::move(w1);
+
+    REQUIRE(w1.expired());
+    REQUIRE(w3.lock() == i);
+
+    w2.reset();
+    REQUIRE(w4.lock() == i);
+
+    i = nullptr;
+    REQUIRE(w3.expired());
+    REQUIRE(w4.expired());
+  }
+
+  SECTION("release before object")
+  {
+    auto i = make_object<Int>(42);
+    {
+      weak_object_ptr w = i;
+      REQUIRE(w.lock() == i);
+    }
+    REQUIRE(i.use_count() == 1);
+    auto j = i;
+    REQUIRE(j.use_count() == 2);
+    j = nullptr;
+    REQUIRE(i.use_count() == 1);
+  }
+
+  SECTION("clone")
+  {
+    auto i = make_object<Int>(42);
+    weak_object_ptr w = i;
+    auto c = clone(i);
+    i = nullptr;
+    REQUIRE(w.expired());
+    REQUIRE(c.use_count() == 1);
+  }
+
+  SECTION("static")
+  {
+    auto t = object_type<Int>();
+    REQUIRE(t.is_static());
+    weak_object_ptr w = t;
+    REQUIRE(!w.expired());
+    REQUIRE(w.lock() == t);
+  }
+}
+
+TEST_CASE("weak_object_ptr concurrent")
+{
+  for (int n = 0; n < 100; ++n) {
+    auto i = make_object<Int>(n);
+    weak_object_ptr w = i;
+
+    std::atomic<bool> start = false;
+    std::atomic<bool> ok = true;
+    std::vector<std::thread> ts;
+
+    for (int t = 0; t < 4; ++t) {
+      ts.emplace_back([&, n] {
+        while (!start)
+          ;
+        for (int k = 0; k < 100; ++k) {
+          if (auto l = w.lock())
+            ok = ok && *l == n;
+        }
+      });
+    }
+
+    start = true;
+    i = nullptr;
+
+    for (auto&& t : ts)
+      t.join();
+
+    REQUIRE(ok);
+    REQUIRE(w.expired());
+  }
+}
\ No newline at end of file